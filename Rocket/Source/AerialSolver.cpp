@@ -0,0 +1,173 @@
+#include "AerialSolver.h"
+#include "BallPredictor.h"
+
+#include "Maths.h"
+
+// Only plan for part of the boost so there is some left over for corrections.
+const float AerialAccelerationMargin = 0.85f;
+
+// Boost while the needed acceleration is at least this much of what boosting gives.
+const float AerialBoostThreshold = 0.5f;
+const float AerialFacingThreshold = 0.9f;
+const float AerialMinTime = 0.2f;
+
+static float GetTurnTime(const CarPhysicsState& state, glm::vec3 direction)
+{
+    float cosAngle = glm::clamp(glm::dot(state.GetForwardVector(), direction), -1.0f, 1.0f);
+    return acosf(cosAngle) / AerialTurnRate;
+}
+
+glm::vec3 AerialSolver::GetBallisticPosition(const CarPhysicsState& state, bool jump, bool doubleJump, float time)
+{
+    const glm::vec3 gravity = glm::vec3(0.0f, -DefaultGravity, 0.0f);
+    glm::vec3 velocity = state.mVelocity;
+
+    if (jump)
+    {
+        velocity += state.mSmoothedSurfaceNormal * JumpSpeed;
+    }
+
+    glm::vec3 position = state.mPosition + velocity * time + 0.5f * gravity * time * time;
+
+    if (doubleJump && time > AERIAL_DOUBLE_JUMP_TIME)
+    {
+        // The car is held level until the double jump, so it goes straight up.
+        position.y += JumpSpeed * (time - AERIAL_DOUBLE_JUMP_TIME);
+    }
+
+    return position;
+}
+
+bool AerialSolver::Solve(const AerialRequest& request, AerialPlan& outPlan)
+{
+    const CarPhysicsState& state = request.mCarState;
+    const BallPredictor* predictor = request.mBallPredictor;
+
+    if (predictor == nullptr ||
+        !predictor->IsValid())
+    {
+        return false;
+    }
+
+    bool grounded = state.mGrounded && state.mSurfaceAligned;
+
+    // Taking off from walls and ceilings isn't handled.
+    if (grounded &&
+        state.mSmoothedSurfaceNormal.y < 0.9f)
+    {
+        return false;
+    }
+
+    float maxAcceleration = AerialBoostAcceleration * AerialAccelerationMargin;
+
+    // Only double jump straight after taking off, while the car is still level.
+    bool canDoubleJump = grounded;
+
+    for (uint32_t i = 0; i < predictor->GetNumSlots(); ++i)
+    {
+        float time = predictor->GetSlot(i).mTime - predictor->GetTime();
+
+        if (time < AerialMinTime)
+        {
+            continue;
+        }
+
+        if (time > request.mHorizon)
+        {
+            break;
+        }
+
+        glm::vec3 target = predictor->GetSlot(i).mPosition + request.mTargetOffset;
+
+        if (target.y < request.mMinHeight)
+        {
+            continue;
+        }
+
+        // Try the single jump first, it leaves the double jump for later.
+        for (uint32_t variant = 0; variant < 2; ++variant)
+        {
+            bool doubleJump = (variant == 1);
+
+            if (doubleJump && !canDoubleJump)
+            {
+                continue;
+            }
+
+            glm::vec3 delta = target - GetBallisticPosition(state, grounded, doubleJump, time);
+            float distance = glm::length(delta);
+            glm::vec3 direction = (distance > 0.001f) ? (delta / distance) : state.GetForwardVector();
+
+            // No useful boost until the car has jumped, double jumped and turned to face the target.
+            float boostStart = GetTurnTime(state, direction);
+            if (doubleJump)
+            {
+                boostStart += AERIAL_DOUBLE_JUMP_TIME;
+            }
+
+            float boostTime = time - boostStart;
+
+            if (boostTime <= 0.0f)
+            {
+                continue;
+            }
+
+            float acceleration = 2.0f * distance / (boostTime * boostTime);
+            float fuelNeeded = boostTime * (acceleration / AerialBoostAcceleration) * BoostDepletionSpeed;
+
+            if (acceleration <= maxAcceleration &&
+                fuelNeeded <= state.mBoostFuel)
+            {
+                outPlan.mTarget = target;
+                outPlan.mInterceptTime = time;
+                outPlan.mAcceleration = direction * acceleration;
+                outPlan.mJump = grounded;
+                outPlan.mDoubleJump = doubleJump;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+CarInput AerialSolver::GetInput(const AerialPlan& plan, const CarPhysicsState& state, float elapsedTime)
+{
+    CarInput input;
+
+    // Jump, let go, then press again for the double jump. Stay level (no stick) until it's done,
+    // otherwise the double jump turns into a flip. Input may only change once per frame,
+    // so the release is keyed off the car's state rather than the clock.
+    if (plan.mJump &&
+        elapsedTime < AERIAL_JUMP_HOLD_TIME)
+    {
+        input.mJump = true;
+        return input;
+    }
+
+    if (plan.mDoubleJump &&
+        state.mDoubleJump)
+    {
+        input.mJump = !state.mJumpHeld && (elapsedTime >= AERIAL_DOUBLE_JUMP_TIME);
+        return input;
+    }
+
+    // Acceleration still needed to get from here to the target in the time that's left.
+    float timeLeft = glm::max(plan.mInterceptTime - elapsedTime, SIM_TIME_STEP);
+    glm::vec3 gravity = glm::vec3(0.0f, -DefaultGravity, 0.0f);
+    glm::vec3 delta = plan.mTarget - (state.mPosition + state.mVelocity * timeLeft + 0.5f * gravity * timeLeft * timeLeft);
+    glm::vec3 acceleration = 2.0f * delta / (timeLeft * timeLeft);
+    float accelerationMag = glm::length(acceleration);
+    glm::vec3 direction = (accelerationMag > 0.001f) ? (acceleration / accelerationMag) : state.GetForwardVector();
+
+    // Pitch and yaw toward the direction, in the car's local space (forward is -Z).
+    glm::vec3 localDir = glm::inverse(state.mRotation) * direction;
+    input.mMotionX = glm::clamp(localDir.x * 4.0f, -1.0f, 1.0f);
+    input.mMotionY = glm::clamp(-localDir.y * 4.0f, -1.0f, 1.0f);
+
+    input.mBoost =
+        glm::dot(state.GetForwardVector(), direction) >= AerialFacingThreshold &&
+        accelerationMag >= AerialBoostAcceleration * AerialBoostThreshold;
+
+    return input;
+}
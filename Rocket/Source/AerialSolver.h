@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CarPhysics.h"
+#include "RocketConstants.h"
+
+#include <stdint.h>
+#include <glm/glm.hpp>
+
+class BallPredictor;
+
+#define AERIAL_MIN_HEIGHT 3.5f
+#define AERIAL_JUMP_HOLD_TIME (2.0f / SIM_TICK_RATE)
+#define AERIAL_DOUBLE_JUMP_TIME (4.0f / SIM_TICK_RATE)
+
+struct AerialRequest
+{
+    CarPhysicsState mCarState;
+    const BallPredictor* mBallPredictor = nullptr;
+
+    // Where on the ball to aim the car's center, relative to the ball's center.
+    glm::vec3 mTargetOffset = {};
+
+    // Latest intercept to consider, in seconds from now.
+    float mHorizon = 2.0f;
+
+    // Intercepts below this height are left to ground play.
+    float mMinHeight = AERIAL_MIN_HEIGHT;
+};
+
+// An intercept and how to fly to it. Times are relative to when the aerial starts.
+struct AerialPlan
+{
+    glm::vec3 mTarget = {};
+    float mInterceptTime = 0.0f;
+
+    // Average acceleration needed from boost once the car is facing the right way.
+    glm::vec3 mAcceleration = {};
+
+    bool mJump = false;
+    bool mDoubleJump = false;
+};
+
+// Finds the earliest ball intercept a car can reach by jumping, double jumping and boosting through the air,
+// using the same JumpSpeed / AerialBoostAcceleration / AerialTurnRate model as CarPhysics.
+// For each predicted ball slot the car's ballistic path (jumps and gravity) is solved in closed form,
+// and the rest of the way is covered by constant boost acceleration once the car has turned to face it.
+// The first slot that needs no more than AerialBoostAcceleration (and fuel the car has) is the intercept.
+namespace AerialSolver
+{
+    bool Solve(const AerialRequest& request, AerialPlan& outPlan);
+
+    // Input for this tick of a solved aerial, elapsedTime after it started. Re-aims at the plan's
+    // target from the car's current state so that it corrects for drift along the way.
+    CarInput GetInput(const AerialPlan& plan, const CarPhysicsState& state, float elapsedTime);
+
+    // Where the car's jumps and gravity alone take it after time.
+    glm::vec3 GetBallisticPosition(const CarPhysicsState& state, bool jump, bool doubleJump, float time);
+}
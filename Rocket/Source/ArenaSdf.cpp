@@ -0,0 +1,441 @@
+#include "ArenaSdf.h"
+#include "RocketConstants.h"
+
+#include "World.h"
+#include "Stream.h"
+#include "Log.h"
+#include "Maths.h"
+
+#include "System/System.h"
+
+#include "Bullet/btBulletDynamicsCommon.h"
+
+#include <float.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+const uint32_t SdfMagic = 0x46445341; // "ASDF"
+const uint32_t SdfVersion = 1;
+const float SdfQuantizeScale = 128.0f;
+const float SdfContactSkin = 0.01f;
+const float SdfMinStep = 0.02f;
+const uint32_t SdfMaxSweepSteps = 64;
+
+// Magic, version, origin, cell size and dimensions. The whole file is little-endian on every platform.
+const uint32_t SdfHeaderSize = 36;
+
+static uint32_t ReadLittleUint32(const uint8_t* data)
+{
+    return uint32_t(data[0]) |
+        (uint32_t(data[1]) << 8) |
+        (uint32_t(data[2]) << 16) |
+        (uint32_t(data[3]) << 24);
+}
+
+static float ReadLittleFloat(const uint8_t* data)
+{
+    uint32_t bits = ReadLittleUint32(data);
+    float value = 0.0f;
+    memcpy(&value, &bits, sizeof(float));
+    return value;
+}
+
+static void WriteLittleUint32(std::vector<uint8_t>& data, uint32_t value)
+{
+    data.push_back(uint8_t(value & 0xff));
+    data.push_back(uint8_t((value >> 8) & 0xff));
+    data.push_back(uint8_t((value >> 16) & 0xff));
+    data.push_back(uint8_t((value >> 24) & 0xff));
+}
+
+static void WriteLittleFloat(std::vector<uint8_t>& data, float value)
+{
+    uint32_t bits = 0;
+    memcpy(&bits, &value, sizeof(float));
+    WriteLittleUint32(data, bits);
+}
+
+bool ArenaSdf::Load(const char* path)
+{
+    Clear();
+
+    if (!SYS_DoesFileExist(path, true))
+    {
+        return false;
+    }
+
+    Stream stream;
+    stream.ReadFile(path, true);
+
+    const uint8_t* data = (const uint8_t*)stream.GetData();
+    uint32_t size = stream.GetSize();
+
+    if (size < SdfHeaderSize ||
+        ReadLittleUint32(data) != SdfMagic ||
+        ReadLittleUint32(data + 4) != SdfVersion)
+    {
+        LogWarning("Arena SDF %s is out of date", path);
+        return false;
+    }
+
+    mOrigin.x = ReadLittleFloat(data + 8);
+    mOrigin.y = ReadLittleFloat(data + 12);
+    mOrigin.z = ReadLittleFloat(data + 16);
+    mCellSize = ReadLittleFloat(data + 20);
+    mDimX = (int32_t)ReadLittleUint32(data + 24);
+    mDimY = (int32_t)ReadLittleUint32(data + 28);
+    mDimZ = (int32_t)ReadLittleUint32(data + 32);
+
+    // A truncated or corrupt file would read samples past the end of the data.
+    uint64_t numSamples = uint64_t(uint32_t(mDimX)) * uint32_t(mDimY) * uint32_t(mDimZ);
+    uint64_t payloadSize = size - SdfHeaderSize;
+
+    if (mDimX <= 0 || mDimY <= 0 || mDimZ <= 0 ||
+        numSamples * sizeof(int16_t) != payloadSize)
+    {
+        LogWarning("Arena SDF %s has %dx%dx%d samples but %llu bytes of data", path, mDimX, mDimY, mDimZ, (unsigned long long)payloadSize);
+        Clear();
+        return false;
+    }
+
+    mSamples.resize(mDimX * mDimY * mDimZ);
+    const uint8_t* samples = data + SdfHeaderSize;
+
+    for (uint32_t i = 0; i < mSamples.size(); ++i)
+    {
+        mSamples[i] = int16_t(uint16_t(samples[i * 2]) | (uint16_t(samples[i * 2 + 1]) << 8));
+    }
+
+    return true;
+}
+
+bool ArenaSdf::Save(const char* path) const
+{
+    if (!IsLoaded())
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> data;
+    data.reserve(SdfHeaderSize + mSamples.size() * sizeof(int16_t));
+    WriteLittleUint32(data, SdfMagic);
+    WriteLittleUint32(data, SdfVersion);
+    WriteLittleFloat(data, mOrigin.x);
+    WriteLittleFloat(data, mOrigin.y);
+    WriteLittleFloat(data, mOrigin.z);
+    WriteLittleFloat(data, mCellSize);
+    WriteLittleUint32(data, (uint32_t)mDimX);
+    WriteLittleUint32(data, (uint32_t)mDimY);
+    WriteLittleUint32(data, (uint32_t)mDimZ);
+
+    for (uint32_t i = 0; i < mSamples.size(); ++i)
+    {
+        uint16_t sample = uint16_t(mSamples[i]);
+        data.push_back(uint8_t(sample & 0xff));
+        data.push_back(uint8_t(sample >> 8));
+    }
+
+    std::string dir = path;
+    size_t slash = dir.find_last_of('/');
+
+    if (slash != std::string::npos)
+    {
+        SYS_CreateDirectory(dir.substr(0, slash).c_str());
+    }
+
+    FILE* file = fopen(path, "wb");
+
+    if (file == nullptr)
+    {
+        LogWarning("Failed to open arena SDF %s for writing", path);
+        return false;
+    }
+
+    bool written = (fwrite(data.data(), 1, data.size(), file) == data.size());
+    written = (fclose(file) == 0) && written;
+
+    if (!written)
+    {
+        LogWarning("Failed to write arena SDF %s", path);
+    }
+
+    return written;
+}
+
+void ArenaSdf::Bake(World* world, uint8_t collisionMask)
+{
+    Clear();
+
+    btDynamicsWorld* dynamicsWorld = world->GetDynamicsWorld();
+
+    glm::vec3 extent = glm::vec3(ARENA_EXTENT_X, ARENA_EXTENT_Y, ARENA_EXTENT_Z);
+    mOrigin = glm::vec3(-extent.x, 0.0f, -extent.z) - glm::vec3(ARENA_SDF_MARGIN);
+    mCellSize = ARENA_SDF_CELL_SIZE;
+    mDimX = int32_t((extent.x * 2.0f + ARENA_SDF_MARGIN * 2.0f) / mCellSize) + 1;
+    mDimY = int32_t((extent.y + ARENA_SDF_MARGIN * 2.0f) / mCellSize) + 1;
+    mDimZ = int32_t((extent.z * 2.0f + ARENA_SDF_MARGIN * 2.0f) / mCellSize) + 1;
+
+    uint32_t numSamples = uint32_t(mDimX * mDimY * mDimZ);
+    std::vector<float> distances(numSamples, FLT_MAX);
+    std::vector<int8_t> signs(numSamples, 1);
+
+    // Seed the samples near the surface by casting rays along every grid line in all three axes
+    // and measuring the distance to the plane of each triangle they pass through.
+    int32_t dims[3] = { mDimX, mDimY, mDimZ };
+
+    for (int32_t axis = 0; axis < 3; ++axis)
+    {
+        int32_t axisU = (axis + 1) % 3;
+        int32_t axisV = (axis + 2) % 3;
+
+        for (int32_t u = 0; u < dims[axisU]; ++u)
+        {
+            for (int32_t v = 0; v < dims[axisV]; ++v)
+            {
+                int32_t coord[3] = {};
+                coord[axisU] = u;
+                coord[axisV] = v;
+
+                glm::vec3 rayStart = mOrigin + glm::vec3(coord[0], coord[1], coord[2]) * mCellSize;
+                glm::vec3 rayEnd = rayStart;
+                rayStart[axis] -= mCellSize;
+                rayEnd[axis] += dims[axis] * mCellSize;
+
+                // Backfaces are filtered so that the reported normals are the real triangle normals
+                // (otherwise Bullet flips them towards the ray). That means casting both ways to see every face.
+                for (int32_t r = 0; r < 2; ++r)
+                {
+                    glm::vec3 from = (r == 0) ? rayStart : rayEnd;
+                    glm::vec3 to = (r == 0) ? rayEnd : rayStart;
+                    btVector3 btStart(from.x, from.y, from.z);
+                    btVector3 btEnd(to.x, to.y, to.z);
+
+                    btCollisionWorld::AllHitsRayResultCallback callback(btStart, btEnd);
+                    callback.m_collisionFilterGroup = ColGroupCar;
+                    callback.m_collisionFilterMask = collisionMask;
+                    callback.m_flags |= btTriangleRaycastCallback::kF_FilterBackfaces;
+                    dynamicsWorld->rayTest(btStart, btEnd, callback);
+
+                    for (int32_t h = 0; h < callback.m_hitPointWorld.size(); ++h)
+                    {
+                        const btVector3& btPoint = callback.m_hitPointWorld[h];
+                        const btVector3& btNormal = callback.m_hitNormalWorld[h];
+                        glm::vec3 point = glm::vec3(btPoint.x(), btPoint.y(), btPoint.z());
+                        glm::vec3 normal = glm::vec3(btNormal.x(), btNormal.y(), btNormal.z());
+
+                        int32_t center = int32_t((point[axis] - mOrigin[axis]) / mCellSize);
+                        for (int32_t k = center - 1; k <= center + 2; ++k)
+                        {
+                            if (k < 0 || k >= dims[axis])
+                                continue;
+
+                            coord[axis] = k;
+                            glm::vec3 samplePos = mOrigin + glm::vec3(coord[0], coord[1], coord[2]) * mCellSize;
+                            float planeDist = glm::dot(samplePos - point, normal);
+
+                            uint32_t index = GetIndex(coord[0], coord[1], coord[2]);
+                            if (fabs(planeDist) < distances[index])
+                            {
+                                distances[index] = fabs(planeDist);
+                                signs[index] = (planeDist < 0.0f) ? -1 : 1;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Propagate the seeds through the rest of the grid (chamfer distance, forward then backward).
+    for (int32_t pass = 0; pass < 2; ++pass)
+    {
+        int32_t step = (pass == 0) ? 1 : -1;
+        int32_t startX = (pass == 0) ? 0 : mDimX - 1;
+        int32_t startY = (pass == 0) ? 0 : mDimY - 1;
+        int32_t startZ = (pass == 0) ? 0 : mDimZ - 1;
+
+        for (int32_t z = startZ; z >= 0 && z < mDimZ; z += step)
+        {
+            for (int32_t y = startY; y >= 0 && y < mDimY; y += step)
+            {
+                for (int32_t x = startX; x >= 0 && x < mDimX; x += step)
+                {
+                    uint32_t index = GetIndex(x, y, z);
+
+                    for (int32_t dz = -1; dz <= 1; ++dz)
+                    {
+                        for (int32_t dy = -1; dy <= 1; ++dy)
+                        {
+                            for (int32_t dx = -1; dx <= 1; ++dx)
+                            {
+                                int32_t nx = x + dx;
+                                int32_t ny = y + dy;
+                                int32_t nz = z + dz;
+
+                                if ((dx == 0 && dy == 0 && dz == 0) ||
+                                    nx < 0 || ny < 0 || nz < 0 ||
+                                    nx >= mDimX || ny >= mDimY || nz >= mDimZ)
+                                {
+                                    continue;
+                                }
+
+                                uint32_t neighborIndex = GetIndex(nx, ny, nz);
+                                float dist = distances[neighborIndex] + sqrtf(float(dx * dx + dy * dy + dz * dz)) * mCellSize;
+
+                                if (dist < distances[index])
+                                {
+                                    distances[index] = dist;
+                                    signs[index] = signs[neighborIndex];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    mSamples.resize(numSamples);
+    for (uint32_t i = 0; i < numSamples; ++i)
+    {
+        float dist = glm::clamp(distances[i] * signs[i] * SdfQuantizeScale, -32767.0f, 32767.0f);
+        mSamples[i] = int16_t(dist);
+    }
+}
+
+void ArenaSdf::Clear()
+{
+    mSamples.clear();
+    mDimX = 0;
+    mDimY = 0;
+    mDimZ = 0;
+}
+
+bool ArenaSdf::IsLoaded() const
+{
+    return !mSamples.empty();
+}
+
+bool ArenaSdf::Contains(glm::vec3 position) const
+{
+    glm::vec3 gridPos = (position - mOrigin) / mCellSize;
+
+    return IsLoaded() &&
+        gridPos.x >= 0.0f && gridPos.x <= float(mDimX - 1) &&
+        gridPos.y >= 0.0f && gridPos.y <= float(mDimY - 1) &&
+        gridPos.z >= 0.0f && gridPos.z <= float(mDimZ - 1);
+}
+
+glm::vec3 ArenaSdf::GetBoundsMin() const
+{
+    return mOrigin;
+}
+
+glm::vec3 ArenaSdf::GetBoundsMax() const
+{
+    return mOrigin + glm::vec3(float(mDimX - 1), float(mDimY - 1), float(mDimZ - 1)) * mCellSize;
+}
+
+float ArenaSdf::GetDistance(glm::vec3 position) const
+{
+    glm::vec3 gridPos = (position - mOrigin) / mCellSize;
+    gridPos = glm::clamp(gridPos, glm::vec3(0.0f), glm::vec3(float(mDimX - 2), float(mDimY - 2), float(mDimZ - 2)) + 0.999f);
+
+    int32_t x = int32_t(gridPos.x);
+    int32_t y = int32_t(gridPos.y);
+    int32_t z = int32_t(gridPos.z);
+    glm::vec3 alpha = gridPos - glm::vec3(x, y, z);
+
+    float d00 = glm::mix(GetSample(x, y, z), GetSample(x + 1, y, z), alpha.x);
+    float d10 = glm::mix(GetSample(x, y + 1, z), GetSample(x + 1, y + 1, z), alpha.x);
+    float d01 = glm::mix(GetSample(x, y, z + 1), GetSample(x + 1, y, z + 1), alpha.x);
+    float d11 = glm::mix(GetSample(x, y + 1, z + 1), GetSample(x + 1, y + 1, z + 1), alpha.x);
+
+    float d0 = glm::mix(d00, d10, alpha.y);
+    float d1 = glm::mix(d01, d11, alpha.y);
+
+    return glm::mix(d0, d1, alpha.z);
+}
+
+glm::vec3 ArenaSdf::GetNormal(glm::vec3 position) const
+{
+    const float h = mCellSize * 0.5f;
+
+    glm::vec3 gradient;
+    gradient.x = GetDistance(position + glm::vec3(h, 0.0f, 0.0f)) - GetDistance(position - glm::vec3(h, 0.0f, 0.0f));
+    gradient.y = GetDistance(position + glm::vec3(0.0f, h, 0.0f)) - GetDistance(position - glm::vec3(0.0f, h, 0.0f));
+    gradient.z = GetDistance(position + glm::vec3(0.0f, 0.0f, h)) - GetDistance(position - glm::vec3(0.0f, 0.0f, h));
+
+    return Maths::SafeNormalize(gradient);
+}
+
+bool ArenaSdf::SweepSphere(glm::vec3 start, glm::vec3 end, float radius, CarSweepResult& outResult) const
+{
+    outResult = CarSweepResult();
+    outResult.mPosition = end;
+    outResult.mContactType = CarContactType::Environment;
+
+    glm::vec3 delta = end - start;
+    float length = glm::length(delta);
+
+    if (length <= 0.0f)
+    {
+        outResult.mPosition = start;
+        return false;
+    }
+
+    glm::vec3 dir = delta / length;
+    float t = 0.0f;
+    float safeT = 0.0f;
+
+    // Sphere trace. Step by the distance to the nearest surface, which can never overshoot it.
+    for (uint32_t i = 0; i < SdfMaxSweepSteps; ++i)
+    {
+        glm::vec3 pos = start + dir * t;
+        float dist = GetDistance(pos);
+        float separation = dist - radius;
+        safeT = t;
+
+        if (separation <= SdfContactSkin)
+        {
+            // Like Bullet, ignore contacts we are already moving away from.
+            glm::vec3 normal = GetNormal(pos);
+            if (glm::dot(normal, dir) < 0.0f)
+            {
+                outResult.mPosition = pos;
+                outResult.mHitPosition = pos - normal * dist;
+                outResult.mHitNormal = normal;
+                outResult.mHitFraction = t / length;
+                return true;
+            }
+        }
+
+        if (t >= length)
+        {
+            return false;
+        }
+
+        t = glm::min(t + glm::max(separation, SdfMinStep), length);
+    }
+
+    // Out of steps before reaching the end, which happens when grazing along a wall.
+    // Stop at the last point that was checked instead of letting the rest of the path tunnel through.
+    glm::vec3 pos = start + dir * safeT;
+    glm::vec3 normal = GetNormal(pos);
+    outResult.mPosition = pos;
+    outResult.mHitPosition = pos - normal * GetDistance(pos);
+    outResult.mHitNormal = normal;
+    outResult.mHitFraction = safeT / length;
+    return true;
+}
+
+uint32_t ArenaSdf::GetIndex(int32_t x, int32_t y, int32_t z) const
+{
+    return uint32_t(x + mDimX * (y + mDimY * z));
+}
+
+float ArenaSdf::GetSample(int32_t x, int32_t y, int32_t z) const
+{
+    return mSamples[GetIndex(x, y, z)] * (1.0f / SdfQuantizeScale);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CarPhysics.h"
+
+#include <stdint.h>
+#include <vector>
+#include <glm/glm.hpp>
+
+class World;
+
+#define ARENA_SDF_CELL_SIZE 1.0f
+#define ARENA_SDF_MARGIN 8.0f
+
+// Signed distance to the static arena geometry, sampled on a regular grid.
+// Baked from the Bullet world in editor builds and saved under Assets/Collision, then loaded at match start
+// so that car sweeps and grounding probes against the environment don't go through Bullet.
+class ArenaSdf
+{
+public:
+
+    bool Load(const char* path);
+    bool Save(const char* path) const;
+    void Bake(World* world, uint8_t collisionMask);
+    void Clear();
+
+    bool IsLoaded() const;
+    bool Contains(glm::vec3 position) const;
+    glm::vec3 GetBoundsMin() const;
+    glm::vec3 GetBoundsMax() const;
+    float GetDistance(glm::vec3 position) const;
+    glm::vec3 GetNormal(glm::vec3 position) const;
+    bool SweepSphere(glm::vec3 start, glm::vec3 end, float radius, CarSweepResult& outResult) const;
+
+protected:
+
+    uint32_t GetIndex(int32_t x, int32_t y, int32_t z) const;
+    float GetSample(int32_t x, int32_t y, int32_t z) const;
+
+    glm::vec3 mOrigin = {};
+    float mCellSize = ARENA_SDF_CELL_SIZE;
+    int32_t mDimX = 0;
+    int32_t mDimY = 0;
+    int32_t mDimZ = 0;
+
+    // Distances quantized to 1/128th of a unit.
+    std::vector<int16_t> mSamples;
+};
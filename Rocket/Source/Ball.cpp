@@ -1,7 +1,9 @@
 #include "Ball.h"
 #include "Car.h"
 #include "GameState.h"
+#include "MatchState.h"
 #include "RocketTypes.h"
+#include "RocketConstants.h"
 
 #include "InputDevices.h"
 #include "AssetManager.h"
@@ -15,13 +17,15 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/rotate_vector.hpp>
 
+#include <algorithm>
+
 #include "Bullet/btBulletDynamicsCommon.h"
 
 const float BallLaunchSpeedMult = 1.5f;
-const float BallSoftSpeedLimit = 30.0f;
-const float BallHardSpeedLimit = 80.0f;
+const uint32_t BallMaxContactPasses = 3;
 
 const glm::vec3 RootRelativeShadowPos = glm::vec3(0.0f, -20.0f, 0.0f);
+const glm::quat ShadowWorldRotation = glm::quat(0.0f, 1.0f, 0.0f, 0.0f); // 180 degrees about X
 
 DEFINE_NODE(Ball, Node3D);
 
@@ -37,6 +41,11 @@ void Ball::M_GoalExplode(Node* node)
 {
     Ball* ball = (Ball*) node;
 
+    if (GetGameState()->mHeadless)
+    {
+        return;
+    }
+
     World* world = ball->GetWorld();
     if (world != nullptr)
     {
@@ -66,27 +75,22 @@ void Ball::Create()
     StaticMesh3D::Create();
 
     SetName("Ball");
-    SetMass(1.0f);
-    SetScale(glm::vec3(1.5f, 1.5f, 1.5f));
-    EnablePhysics(NetIsAuthority());
+    SetScale(glm::vec3(BALL_RADIUS, BALL_RADIUS, BALL_RADIUS));
+    // Stepped by BallPhysics on the fixed sim clock, the body is only there for collision queries.
+    // Restitution and friction live in BallPhysics.
+    EnablePhysics(false);
     EnableCollision(true);
     EnableOverlaps(true);
     SetCollisionGroup(ColGroupBall);
-    SetRestitution(0.4f);
-    SetAngularFactor({ 1.0f, 1.0f, 1.0f });
-    SetRollingFriction(1.0f);
-    SetFriction(1.0f);
     EnableCastShadows(true);
     EnableReceiveSimpleShadows(false);
-    //SetFriction(0.0f);
-    //SetAngularFactor(glm::vec3(0.0f, 0.0f, 0.0f));
-    //SetAngularDamping(1.0f);
     SetStaticMesh((StaticMesh*)LoadAsset("SM_Sphere"));
 
     MaterialLite* ballMat = (MaterialLite*)LoadAsset("M_Ball");
     ballMat->SetFresnelEnabled(true);
     ballMat->SetFresnelColor({ 1.0f, 1.0f, 1.0f, 1.0f });
     SetMaterialOverride(ballMat);
+    mFresnelTrack = GetGameState()->mMaterialAnimator.AddDamp(ballMat, MaterialParam::FresnelColor, { 1.0f, 1.0f, 1.0f, 1.0f }, 0.005f);
 
     mShadowComponent = CreateChild<ShadowMesh3D>("Shadow");
     mShadowComponent->SetStaticMesh(LoadAsset<StaticMesh>("SM_Cone"));
@@ -103,57 +107,260 @@ void Ball::Create()
     mGoalSound = LoadAsset("SW_Goal");
 }
 
+void Ball::Destroy()
+{
+    GetGameState()->mMaterialAnimator.RemoveTrack(mFresnelTrack);
+    mFresnelTrack = INVALID_MATERIAL_TRACK;
+
+    StaticMesh3D::Destroy();
+}
+
 void Ball::Tick(float deltaTime)
 {
     StaticMesh3D::Tick(deltaTime);
 
-    if (NetIsAuthority())
+    UpdateShadowTransform();
+
+    // Fade the fresnel color to the last hit team's color.
+    if (mFresnelTrack != INVALID_MATERIAL_TRACK)
     {
-        mTimeSinceLastHit += deltaTime;
-        mTimeSinceLastGrounded += deltaTime;
+        glm::vec4 targetColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
 
-        if (mGrounded && mTimeSinceLastGrounded > 0.3f)
+        if (mLastHitTeam == 0)
+        {
+            targetColor = glm::vec4(1.0f, 0.5f, 0.0f, 1.0f);
+        }
+        else if (mLastHitTeam == 1)
         {
-            mGrounded = false;
+            targetColor = glm::vec4(0.0f, 0.5f, 1.0f, 1.0f);
         }
 
-        glm::vec3 velocity = GetLinearVelocity();
-        float speed = glm::length(velocity);
-        glm::vec3 direction = (speed != 0.0f) ? velocity / speed : glm::vec3(0.0f);
+        GetGameState()->mMaterialAnimator.SetTarget(mFresnelTrack, targetColor);
+    }
+}
 
-        if (speed > BallSoftSpeedLimit)
-        {
-            if (speed > BallHardSpeedLimit)
-            {
-                speed = BallHardSpeedLimit;
-            }
+void Ball::UpdateShadowTransform()
+{
+    glm::quat rotation = GetRotationQuat();
+
+    // The shadow's offset is fixed in world space, so its relative transform only changes when the ball rotates.
+    if (rotation == mShadowParentRotation)
+    {
+        return;
+    }
+
+    mShadowParentRotation = rotation;
+
+    glm::quat invRotation = glm::inverse(rotation);
+    mShadowComponent->SetPosition(invRotation * RootRelativeShadowPos);
+    mShadowComponent->SetRotation(invRotation * ShadowWorldRotation);
+}
+
+void Ball::BeginSimStep()
+{
+    // The node may have been left at a blended transform for rendering.
+    // Put it back where the simulation has it, this step's car sweeps run against it.
+    mPrevPhysicsPosition = mPhysics.mPosition;
+    mPrevPhysicsRotation = mPhysics.mRotation;
+    SetPosition(mPhysics.mPosition);
+    SetRotation(mPhysics.mRotation);
+}
+
+void Ball::UpdateSimulation(float deltaTime)
+{
+    mTimeSinceLastHit += deltaTime;
+    mTimeSinceLastGrounded += deltaTime;
+
+    if (mGrounded && mTimeSinceLastGrounded > 0.3f)
+    {
+        mGrounded = false;
+    }
 
-            speed = Maths::Damp(speed, BallSoftSpeedLimit, 0.005f, deltaTime);
+    if (!mAlive)
+    {
+        mNumImpacts = 0;
+        return;
+    }
+
+    btVector3 btGravity = GetWorld()->GetDynamicsWorld()->getGravity();
+    glm::vec3 gravity = glm::vec3(btGravity.x(), btGravity.y(), btGravity.z());
+    glm::vec3 groundNormal = {};
+
+    // Touches were applied to the velocity as they happened, in car order. Replay them in time order,
+    // travelling at each touch's incoming velocity up to it. Whatever gravity and contacts did
+    // to the velocity along the way is carried over to the next segment.
+    glm::vec3 finalVelocity = mPhysics.mVelocity;
+    glm::vec3 carriedVelocity = {};
+    float time = 0.0f;
+
+    std::sort(mImpacts, mImpacts + mNumImpacts, [](const Impact& a, const Impact& b) { return a.mTime < b.mTime; });
+
+    for (uint32_t i = 0; i <= mNumImpacts; ++i)
+    {
+        float endTime = (i < mNumImpacts) ? glm::clamp(mImpacts[i].mTime, time, deltaTime) : deltaTime;
+        glm::vec3 startVelocity = (i < mNumImpacts) ? mImpacts[i].mPreImpactVelocity : finalVelocity;
+
+        mPhysics.mVelocity = startVelocity + carriedVelocity;
 
-            SetLinearVelocity(speed * direction);
+        if (endTime > time)
+        {
+            glm::vec3 normal = StepPhysics(endTime - time, gravity);
+            groundNormal = (normal.y > groundNormal.y) ? normal : groundNormal;
         }
+
+        carriedVelocity = mPhysics.mVelocity - startVelocity;
+        time = endTime;
+    }
+
+    mNumImpacts = 0;
+
+    SetPosition(mPhysics.mPosition);
+    SetRotation(mPhysics.mRotation);
+
+    if (groundNormal.y > 0.8f)
+    {
+        mGrounded = true;
+        mTimeSinceLastGrounded = 0.0f;
+    }
+}
+
+glm::vec3 Ball::StepPhysics(float deltaTime, glm::vec3 gravity)
+{
+    glm::vec3 groundNormal = {};
+
+    MatchState* match = GetMatchState();
+    const ArenaSdf* sdf = (match != nullptr && match->mArenaSdf.IsLoaded()) ? &match->mArenaSdf : nullptr;
+
+    // Without an SDF, Step() would fall back to the arena bounds which have no goals in them.
+    if (mAnalyticPhysics &&
+        sdf != nullptr)
+    {
+        groundNormal = BallPhysics::Step(mPhysics, gravity, deltaTime, sdf);
+    }
+    else
+    {
+        BallPhysics::Integrate(mPhysics, gravity, deltaTime);
+        groundNormal = CollideWorld(deltaTime, gravity);
+        BallPhysics::IntegrateRotation(mPhysics, deltaTime);
+    }
+
+    return groundNormal;
+}
+
+void Ball::AddImpact(glm::vec3 preImpactVelocity, float impactTime)
+{
+    if (mNumImpacts < MAX_CARS)
+    {
+        mImpacts[mNumImpacts].mPreImpactVelocity = preImpactVelocity;
+        mImpacts[mNumImpacts].mTime = impactTime;
+        ++mNumImpacts;
+    }
+}
+
+void Ball::GetStepMotion(glm::vec3& outPosition, glm::vec3& outVelocity) const
+{
+    outPosition = mPhysics.mPosition;
+    outVelocity = mPhysics.mVelocity;
+
+    // Before each touch the ball moved at that touch's incoming velocity, after the last one at its current velocity.
+    // Shift the start so the line through it matches the path from the latest touch on.
+    for (uint32_t i = 0; i < mNumImpacts; ++i)
+    {
+        glm::vec3 nextVelocity = (i + 1 < mNumImpacts) ? mImpacts[i + 1].mPreImpactVelocity : mPhysics.mVelocity;
+        outPosition += (mImpacts[i].mPreImpactVelocity - nextVelocity) * mImpacts[i].mTime;
     }
+}
+
+void Ball::UpdateVisualTransform(float alpha)
+{
+    SetPosition(glm::mix(mPrevPhysicsPosition, mPhysics.mPosition, alpha));
+    SetRotation(glm::slerp(mPrevPhysicsRotation, mPhysics.mRotation, alpha));
+    UpdateShadowTransform();
+}
 
-    mShadowComponent->SetWorldRotation(glm::vec3(180.0f, 0.0f, 0.0f));
-    // TODO-NODE: Shouldn't the following line call SetPosition() instead of SetWorldPosition()
-    mShadowComponent->SetWorldPosition(GetPosition() + RootRelativeShadowPos * GetScale());
+void Ball::ResetInterpolation()
+{
+    mPrevPhysicsPosition = mPhysics.mPosition;
+    mPrevPhysicsRotation = mPhysics.mRotation;
+}
+
+glm::vec3 Ball::GetSimPosition() const
+{
+    // Clients don't simulate the ball, they only have the replicated transform.
+    return NetIsAuthority() ? mPhysics.mPosition : GetPosition();
+}
 
-    // Update fresnel color based on last hit.
-    MaterialLite* liteMat = GetMaterial()->As<MaterialLite>();
-    glm::vec4 fresnelColor = liteMat->GetFresnelColor();
-    glm::vec4 targetColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+void Ball::SetSimPosition(glm::vec3 position)
+{
+    mPhysics.mPosition = position;
+    SetPosition(position);
+}
 
-    if (mLastHitTeam == 0)
+// Deepest environment contact of a sphere, for pushing the ball out of the arena's Bullet collision.
+struct BallContactCallback : public btCollisionWorld::ContactResultCallback
+{
+    virtual btScalar addSingleResult(
+        btManifoldPoint& point,
+        const btCollisionObjectWrapper* wrap0,
+        int partId0,
+        int index0,
+        const btCollisionObjectWrapper* wrap1,
+        int partId1,
+        int index1) override
     {
-        targetColor = glm::vec4(1.0f, 0.5f, 0.0f, 1.0f);
+        if (point.getDistance() < mDistance)
+        {
+            // The normal on B points toward A.
+            mDistance = point.getDistance();
+            mNormal = (wrap0->getCollisionObject() == mObject) ? point.m_normalWorldOnB : -point.m_normalWorldOnB;
+        }
+
+        return 0.0f;
     }
-    else if (mLastHitTeam == 1)
+
+    const btCollisionObject* mObject = nullptr;
+    btVector3 mNormal = btVector3(0.0f, 1.0f, 0.0f);
+    btScalar mDistance = 0.0f;
+};
+
+glm::vec3 Ball::CollideWorld(float deltaTime, glm::vec3 gravity)
+{
+    btDynamicsWorld* dynamicsWorld = GetWorld()->GetDynamicsWorld();
+    btSphereShape sphereShape(BALL_RADIUS);
+    btCollisionObject object;
+    object.setCollisionShape(&sphereShape);
+
+    glm::vec3 groundNormal = {};
+
+    // Resolve the deepest contact each pass so the ball can be pushed out of corners.
+    for (uint32_t i = 0; i < BallMaxContactPasses; ++i)
     {
-        targetColor = glm::vec4(0.0f, 0.5f, 1.0f, 1.0f);
+        btTransform transform;
+        transform.setIdentity();
+        transform.setOrigin(btVector3(mPhysics.mPosition.x, mPhysics.mPosition.y, mPhysics.mPosition.z));
+        object.setWorldTransform(transform);
+
+        BallContactCallback callback;
+        callback.mObject = &object;
+        callback.m_collisionFilterGroup = ColGroupBall;
+        callback.m_collisionFilterMask = ColGroupEnvironment;
+        dynamicsWorld->contactTest(&object, callback);
+
+        if (callback.mDistance >= 0.0f)
+        {
+            break;
+        }
+
+        glm::vec3 normal = glm::vec3(callback.mNormal.x(), callback.mNormal.y(), callback.mNormal.z());
+        BallPhysics::ResolveContact(mPhysics, normal, -callback.mDistance, gravity, deltaTime);
+
+        if (normal.y > groundNormal.y)
+        {
+            groundNormal = normal;
+        }
     }
 
-    fresnelColor = Maths::Damp(fresnelColor, targetColor, 0.005f, deltaTime);
-    liteMat->SetFresnelColor(fresnelColor);
+    return groundNormal;
 }
 
 void Ball::GatherReplicatedData(std::vector<NetDatum>& outData)
@@ -182,7 +389,7 @@ void Ball::OnCollision(
 
         if (car != nullptr)
         {
-            glm::vec3 ballVelocity = GetLinearVelocity();
+            glm::vec3 ballVelocity = GetVelocity();
             glm::vec3 carVelocity = car->GetVelocity();
 
             // (1) Cancel out velocity along collision axis
@@ -194,7 +401,7 @@ void Ball::OnCollision(
             glm::vec3 launchVelocity = impactNormal * launchSpeed;
             ballVelocity += launchVelocity;
 
-            SetLinearVelocity(ballVelocity);
+            SetVelocity(ballVelocity);
 
     #if 0
             // Debug impact
@@ -209,6 +416,8 @@ void Ball::OnCollision(
 
             if (mTimeSinceLastHit > 0.3f)
             {
+                GetGameState()->mSelfPlay.RecordTouch(mLastHitTeam);
+
                 //SoundWave* hitSound = (SoundWave*)LoadAsset("SW_Cannon");
                 //AudioManager::PlaySound3D(
                 //    hitSound,
@@ -230,38 +439,15 @@ void Ball::OnCollision(
     }
 }
 
-void Ball::BeginOverlap(
-    Primitive3D* thisComp,
-    Primitive3D* otherComp
-)
-{
-    if (NetIsAuthority())
-    {
-        const char* otherName = otherComp->GetName().c_str();
-        if (strncmp(otherName, "Goal", 4) == 0)
-        {
-            // Goal hit
-            if (strlen(otherName) == 6)
-            {
-                uint32_t teamGoal = otherName[5] - '0';
-                teamGoal = (teamGoal == 0 || teamGoal == 1) ? teamGoal : 0;
-                uint32_t scoringTeam = (teamGoal + 1) % 2;
-
-                GetMatchState()->HandleGoal(scoringTeam);
-                SetAlive(false);
-                InvokeNetFunc("M_GoalExplode");
-            }
-        }
-    }
-}
-
 void Ball::Reset()
 {
     if (NetIsAuthority())
     {
-        SetPosition(glm::vec3(0.0f, 5.0f, 0.0f));
-        SetLinearVelocity(glm::vec3(0));
-        SetAngularVelocity(glm::vec3(0));
+        SetSimPosition(glm::vec3(0.0f, 5.0f, 0.0f));
+        ResetInterpolation();
+        mNumImpacts = 0;
+        SetVelocity(glm::vec3(0));
+        mPhysics.mAngularVelocity = glm::vec3(0);
         mLastHitTeam = -1;
         SetAlive(true);
     }
@@ -273,11 +459,6 @@ void Ball::SetAlive(bool alive)
     {
         mAlive = alive;
 
-        if (NetIsAuthority())
-        {
-            EnablePhysics(alive);
-        }
-
         EnableCollision(alive);
         EnableOverlaps(alive);
         SetVisible(alive);
@@ -285,3 +466,34 @@ void Ball::SetAlive(bool alive)
         mShadowComponent->SetVisible(alive);
     }
 }
+
+bool Ball::IsAlive() const
+{
+    return mAlive;
+}
+
+void Ball::Explode()
+{
+    SetAlive(false);
+    InvokeNetFunc("M_GoalExplode");
+}
+
+glm::vec3 Ball::GetVelocity()
+{
+    return mPhysics.mVelocity;
+}
+
+void Ball::SetVelocity(glm::vec3 velocity)
+{
+    mPhysics.mVelocity = velocity;
+}
+
+void Ball::EnableAnalyticPhysics(bool enable)
+{
+    mAnalyticPhysics = enable;
+}
+
+bool Ball::IsAnalyticPhysicsEnabled() const
+{
+    return mAnalyticPhysics;
+}
@@ -10,6 +10,9 @@
 #include "Assets/ParticleSystem.h"
 #include "Assets/SoundWave.h"
 
+#include "BallPhysics.h"
+#include "MaterialAnimator.h"
+
 class Ball : public StaticMesh3D
 {
 public:
@@ -20,6 +23,7 @@ public:
     ~Ball();
 
     virtual void Create() override;
+    virtual void Destroy() override;
     virtual void Tick(float deltaTime) override;
     virtual void GatherReplicatedData(std::vector<NetDatum>& outData) override;
     virtual void GatherNetFuncs(std::vector<NetFunc>& outFuncs) override;
@@ -31,13 +35,33 @@ public:
         glm::vec3 impactNormal,
         btPersistentManifold* manifold) override;
 
-    virtual void BeginOverlap(
-        Primitive3D* thisComp,
-        Primitive3D* otherComp
-    ) override;
-
     void Reset();
     void SetAlive(bool alive);
+    bool IsAlive() const;
+    void Explode();
+
+    glm::vec3 GetVelocity();
+    void SetVelocity(glm::vec3 velocity);
+
+    void EnableAnalyticPhysics(bool enable);
+    bool IsAnalyticPhysicsEnabled() const;
+
+    // On the authority the ball is stepped by the MatchState on the fixed sim clock,
+    // and the node is left at a transform blended between the last two steps for rendering.
+    void BeginSimStep();
+    void UpdateSimulation(float deltaTime);
+    void UpdateVisualTransform(float alpha);
+    void ResetInterpolation();
+    glm::vec3 GetSimPosition() const;
+    void SetSimPosition(glm::vec3 position);
+
+    // A car touched the ball impactTime seconds into the current step, when it was moving at preImpactVelocity.
+    // The step is split there so the ball only travels at its new velocity after the touch.
+    void AddImpact(glm::vec3 preImpactVelocity, float impactTime);
+
+    // Position and velocity such that position + velocity * t is where the ball is t seconds into the current step,
+    // from the latest touch on.
+    void GetStepMotion(glm::vec3& outPosition, glm::vec3& outVelocity) const;
 
     static bool OnRep_Alive(Datum* datum, uint32_t index, const void* value);
 
@@ -45,6 +69,10 @@ public:
 
 protected:
 
+    glm::vec3 StepPhysics(float deltaTime, glm::vec3 gravity);
+    glm::vec3 CollideWorld(float deltaTime, glm::vec3 gravity);
+    void UpdateShadowTransform();
+
     ShadowMesh3D* mShadowComponent = nullptr;
     Audio3D* mAudio3D = nullptr;
 
@@ -54,6 +82,31 @@ protected:
     float mTimeSinceLastHit = 0.0f;
     float mTimeSinceLastGrounded = 0.0f;
     int32_t mLastHitTeam = -1;
+
+    // Rotation the shadow was last placed for
+    glm::quat mShadowParentRotation = { 0.0f, 0.0f, 0.0f, 0.0f };
+
     bool mGrounded = false;
     bool mAlive = true;
+
+    // Fresnel color fades to the last hit team's color, see MaterialAnimator.
+    int32_t mFresnelTrack = INVALID_MATERIAL_TRACK;
+
+    // Collide with the arena SDF instead of querying Bullet for environment contacts.
+    bool mAnalyticPhysics = false;
+    BallPhysicsState mPhysics;
+
+    // Sim transform at the start of the last step, for blending the node between steps.
+    glm::vec3 mPrevPhysicsPosition = {};
+    glm::quat mPrevPhysicsRotation = { 1.0f, 0.0f, 0.0f, 0.0f };
+
+    // Car touches during the current step.
+    struct Impact
+    {
+        glm::vec3 mPreImpactVelocity;
+        float mTime;
+    };
+
+    Impact mImpacts[MAX_CARS] = {};
+    uint32_t mNumImpacts = 0;
 };
\ No newline at end of file
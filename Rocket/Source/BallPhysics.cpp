@@ -0,0 +1,138 @@
+#include "BallPhysics.h"
+#include "ArenaSdf.h"
+
+#include "Maths.h"
+
+// Solid sphere: I = 2/5 m r^2
+const float BallInertiaScale = 0.4f * BALL_RADIUS * BALL_RADIUS;
+
+glm::vec3 BallPhysics::Step(BallPhysicsState& state, glm::vec3 gravity, float deltaTime, const ArenaSdf* sdf)
+{
+    Integrate(state, gravity, deltaTime);
+    glm::vec3 groundNormal = CollideArena(state, gravity, deltaTime, sdf);
+    IntegrateRotation(state, deltaTime);
+
+    return groundNormal;
+}
+
+void BallPhysics::Integrate(BallPhysicsState& state, glm::vec3 gravity, float deltaTime)
+{
+    state.mVelocity += gravity * deltaTime;
+    ApplySpeedLimit(state.mVelocity, deltaTime);
+    state.mPosition += state.mVelocity * deltaTime;
+}
+
+glm::vec3 BallPhysics::CollideArena(BallPhysicsState& state, glm::vec3 gravity, float deltaTime, const ArenaSdf* sdf)
+{
+    glm::vec3 groundNormal = {};
+
+    if (sdf != nullptr)
+    {
+        // Past the SDF's bounds the ball is outside the arena (or deep in a goal), there is nothing to hit.
+        float dist = sdf->Contains(state.mPosition) ? sdf->GetDistance(state.mPosition) : BALL_RADIUS;
+
+        if (dist < BALL_RADIUS)
+        {
+            glm::vec3 normal = sdf->GetNormal(state.mPosition);
+            ResolveContact(state, normal, BALL_RADIUS - dist, gravity, deltaTime);
+            groundNormal = normal;
+        }
+    }
+    else
+    {
+        const glm::vec3 minBounds = glm::vec3(-ARENA_EXTENT_X, 0.0f, -ARENA_EXTENT_Z) + BALL_RADIUS;
+        const glm::vec3 maxBounds = glm::vec3(ARENA_EXTENT_X, ARENA_EXTENT_Y, ARENA_EXTENT_Z) - BALL_RADIUS;
+
+        for (uint32_t axis = 0; axis < 3; ++axis)
+        {
+            glm::vec3 normal = {};
+
+            if (state.mPosition[axis] < minBounds[axis])
+            {
+                normal[axis] = 1.0f;
+                ResolveContact(state, normal, minBounds[axis] - state.mPosition[axis], gravity, deltaTime);
+            }
+            else if (state.mPosition[axis] > maxBounds[axis])
+            {
+                normal[axis] = -1.0f;
+                ResolveContact(state, normal, state.mPosition[axis] - maxBounds[axis], gravity, deltaTime);
+            }
+
+            if (normal.y > groundNormal.y)
+            {
+                groundNormal = normal;
+            }
+        }
+    }
+
+    return groundNormal;
+}
+
+void BallPhysics::IntegrateRotation(BallPhysicsState& state, float deltaTime)
+{
+    glm::quat spin = glm::quat(0.0f, state.mAngularVelocity.x, state.mAngularVelocity.y, state.mAngularVelocity.z);
+    state.mRotation = glm::normalize(state.mRotation + (spin * state.mRotation) * (0.5f * deltaTime));
+}
+
+void BallPhysics::ApplySpeedLimit(glm::vec3& velocity, float deltaTime)
+{
+    float speed = glm::length(velocity);
+
+    if (speed > BALL_SOFT_SPEED_LIMIT)
+    {
+        glm::vec3 direction = velocity / speed;
+
+        if (speed > BALL_HARD_SPEED_LIMIT)
+        {
+            speed = BALL_HARD_SPEED_LIMIT;
+        }
+
+        speed = Maths::Damp(speed, BALL_SOFT_SPEED_LIMIT, 0.005f, deltaTime);
+        velocity = speed * direction;
+    }
+}
+
+void BallPhysics::ResolveContact(BallPhysicsState& state, glm::vec3 normal, float penetration, glm::vec3 gravity, float deltaTime)
+{
+    state.mPosition += normal * penetration;
+
+    // Restitution
+    float normalSpeed = glm::dot(state.mVelocity, normal);
+    float normalImpulse = 0.0f;
+
+    if (normalSpeed < 0.0f)
+    {
+        normalImpulse = -(1.0f + BALL_RESTITUTION) * normalSpeed;
+        state.mVelocity += normal * normalImpulse;
+    }
+
+    // Resting contact still needs to hold the ball up against gravity, which is what friction is limited by.
+    normalImpulse = glm::max(normalImpulse, -glm::dot(gravity, normal) * deltaTime);
+
+    // Rolling resistance, like the rolling friction the Bullet body had. An angular impulse against the spin,
+    // limited by the normal impulse. Friction below then bleeds the linear velocity down to match.
+    float spinSpeed = glm::length(state.mAngularVelocity);
+
+    if (spinSpeed > 0.0001f)
+    {
+        float rollingImpulse = glm::min(spinSpeed * BallInertiaScale, BALL_ROLLING_FRICTION * normalImpulse);
+        state.mAngularVelocity -= (state.mAngularVelocity / spinSpeed) * (rollingImpulse / BallInertiaScale);
+    }
+
+    // Friction. Impulse along the contact point's slip direction, limited by the normal impulse.
+    glm::vec3 contactOffset = -normal * BALL_RADIUS;
+    glm::vec3 contactVelocity = state.mVelocity + glm::cross(state.mAngularVelocity, contactOffset);
+    glm::vec3 slip = contactVelocity - normal * glm::dot(contactVelocity, normal);
+    float slipSpeed = glm::length(slip);
+
+    if (slipSpeed > 0.0001f)
+    {
+        glm::vec3 slipDir = slip / slipSpeed;
+
+        // Slip removed per unit impulse is 1 (linear) + r^2 / I (angular) = 3.5 for a solid sphere.
+        float frictionImpulse = glm::min(slipSpeed / 3.5f, BALL_FRICTION * normalImpulse);
+
+        state.mVelocity -= slipDir * frictionImpulse;
+        state.mAngularVelocity += glm::cross(contactOffset, -slipDir * frictionImpulse) / BallInertiaScale;
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "RocketConstants.h"
+
+#include <stdint.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+class ArenaSdf;
+
+#define BALL_FRICTION 1.0f
+#define BALL_ROLLING_FRICTION 1.0f
+
+struct BallPhysicsState
+{
+    glm::vec3 mPosition = { 0.0f, 0.0f, 0.0f };
+    glm::quat mRotation = { 1.0f, 0.0f, 0.0f, 0.0f };
+    glm::vec3 mVelocity = { 0.0f, 0.0f, 0.0f };
+    glm::vec3 mAngularVelocity = { 0.0f, 0.0f, 0.0f };
+};
+
+// Deterministic ball integrator. Steps the authority's ball on the fixed sim clock,
+// and is what BallPredictor runs to predict the ball's path. Step() collides with the arena SDF if one is given,
+// otherwise with the arena bounds. The bounds have no goal mouths, so they are only good enough for prediction.
+// Callers with another collision source run the three parts themselves.
+namespace BallPhysics
+{
+    // Returns the normal of the floor-most contact this step, or zero if the ball touched nothing.
+    glm::vec3 Step(BallPhysicsState& state, glm::vec3 gravity, float deltaTime, const ArenaSdf* sdf);
+
+    void Integrate(BallPhysicsState& state, glm::vec3 gravity, float deltaTime);
+    glm::vec3 CollideArena(BallPhysicsState& state, glm::vec3 gravity, float deltaTime, const ArenaSdf* sdf);
+    void IntegrateRotation(BallPhysicsState& state, float deltaTime);
+
+    void ApplySpeedLimit(glm::vec3& velocity, float deltaTime);
+    void ResolveContact(BallPhysicsState& state, glm::vec3 normal, float penetration, glm::vec3 gravity, float deltaTime);
+}
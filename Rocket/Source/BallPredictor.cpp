@@ -0,0 +1,176 @@
+#include "BallPredictor.h"
+
+#include "Assertion.h"
+
+// How far the real ball may drift from the prediction before the whole path is resimulated.
+const float PositionTolerance = 0.25f;
+const float VelocityTolerance = 1.0f;
+
+void BallPredictor::Update(glm::vec3 position, glm::vec3 velocity, glm::vec3 gravity, float time)
+{
+    mTime = time;
+
+    if (gravity != mGravity ||
+        !Matches(position, velocity, time))
+    {
+        mGravity = gravity;
+        Resimulate(position, velocity, time);
+        return;
+    }
+
+    // Drop the slots that are fully in the past. Keep one at/before the current time to interpolate from.
+    while (mCount >= 2 &&
+        GetSlot(1).mTime <= time)
+    {
+        mHead = (mHead + 1) % BALL_PREDICTION_SLOTS;
+        --mCount;
+    }
+
+    Extend();
+}
+
+void BallPredictor::Invalidate()
+{
+    mHead = 0;
+    mCount = 0;
+}
+
+bool BallPredictor::IsValid() const
+{
+    return mCount > 0;
+}
+
+float BallPredictor::GetTime() const
+{
+    return mTime;
+}
+
+uint32_t BallPredictor::GetNumSlots() const
+{
+    return mCount;
+}
+
+const BallPredictionSlot& BallPredictor::GetSlot(uint32_t index) const
+{
+    OCT_ASSERT(index < mCount);
+    return mSlots[(mHead + index) % BALL_PREDICTION_SLOTS];
+}
+
+glm::vec3 BallPredictor::GetPosition(float timeAhead) const
+{
+    glm::vec3 position;
+    glm::vec3 velocity;
+    Sample(mTime + timeAhead, position, velocity);
+    return position;
+}
+
+glm::vec3 BallPredictor::GetVelocity(float timeAhead) const
+{
+    glm::vec3 position;
+    glm::vec3 velocity;
+    Sample(mTime + timeAhead, position, velocity);
+    return velocity;
+}
+
+float BallPredictor::FindReachTime(glm::vec3 fromPosition, float speed, float maxTime) const
+{
+    for (uint32_t i = 0; i < mCount; ++i)
+    {
+        const BallPredictionSlot& slot = GetSlot(i);
+        float timeAhead = slot.mTime - mTime;
+
+        if (timeAhead > maxTime)
+        {
+            break;
+        }
+
+        if (timeAhead >= 0.0f &&
+            glm::distance(fromPosition, slot.mPosition) <= speed * timeAhead + BALL_RADIUS)
+        {
+            return timeAhead;
+        }
+    }
+
+    return -1.0f;
+}
+
+void BallPredictor::SetArenaSdf(const ArenaSdf* sdf)
+{
+    if (mArenaSdf != sdf)
+    {
+        mArenaSdf = sdf;
+        Invalidate();
+    }
+}
+
+void BallPredictor::Resimulate(glm::vec3 position, glm::vec3 velocity, float time)
+{
+    mHead = 0;
+    mCount = 1;
+    mSlots[0].mPosition = position;
+    mSlots[0].mVelocity = velocity;
+    mSlots[0].mTime = time;
+
+    mTailState = BallPhysicsState();
+    mTailState.mPosition = position;
+    mTailState.mVelocity = velocity;
+
+    Extend();
+}
+
+void BallPredictor::Extend()
+{
+    while (mCount < BALL_PREDICTION_SLOTS &&
+        GetSlot(mCount - 1).mTime < mTime + BALL_PREDICTION_TIME)
+    {
+        // The tail state carries spin along with the slots so friction stays consistent when extending.
+        const BallPredictionSlot& last = GetSlot(mCount - 1);
+        BallPredictionSlot& next = mSlots[(mHead + mCount) % BALL_PREDICTION_SLOTS];
+
+        BallPhysics::Step(mTailState, mGravity, BALL_PREDICTION_STEP, mArenaSdf);
+
+        next.mPosition = mTailState.mPosition;
+        next.mVelocity = mTailState.mVelocity;
+        next.mTime = last.mTime + BALL_PREDICTION_STEP;
+
+        ++mCount;
+    }
+}
+
+bool BallPredictor::Matches(glm::vec3 position, glm::vec3 velocity, float time) const
+{
+    if (mCount < 2 ||
+        time < GetSlot(0).mTime ||
+        time > GetSlot(mCount - 1).mTime)
+    {
+        return false;
+    }
+
+    glm::vec3 predictedPosition;
+    glm::vec3 predictedVelocity;
+    Sample(time, predictedPosition, predictedVelocity);
+
+    return glm::distance(position, predictedPosition) < PositionTolerance &&
+        glm::distance(velocity, predictedVelocity) < VelocityTolerance;
+}
+
+void BallPredictor::Sample(float time, glm::vec3& outPosition, glm::vec3& outVelocity) const
+{
+    if (mCount == 0)
+    {
+        outPosition = {};
+        outVelocity = {};
+        return;
+    }
+
+    const BallPredictionSlot& first = GetSlot(0);
+    float slotPos = glm::clamp((time - first.mTime) / BALL_PREDICTION_STEP, 0.0f, float(mCount - 1));
+    uint32_t index = glm::min(uint32_t(slotPos), mCount - 1);
+    uint32_t nextIndex = glm::min(index + 1, mCount - 1);
+    float alpha = slotPos - float(index);
+
+    const BallPredictionSlot& slot = GetSlot(index);
+    const BallPredictionSlot& nextSlot = GetSlot(nextIndex);
+    outPosition = glm::mix(slot.mPosition, nextSlot.mPosition, alpha);
+    outVelocity = glm::mix(slot.mVelocity, nextSlot.mVelocity, alpha);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "RocketConstants.h"
+#include "BallPhysics.h"
+
+#include <stdint.h>
+#include <glm/glm.hpp>
+
+#define BALL_PREDICTION_TIME 3.0f
+#define BALL_PREDICTION_STEP (1.0f / 30.0f)
+#define BALL_PREDICTION_SLOTS 96
+
+struct BallPredictionSlot
+{
+    glm::vec3 mPosition = {};
+    glm::vec3 mVelocity = {};
+    float mTime = 0.0f;
+};
+
+// Predicted ball path for the next few seconds, stored in a ring buffer.
+// Updated once per tick by the MatchState and read by every bot and camera.
+// While the ball follows the prediction, only the newly exposed end of the path is simulated.
+class BallPredictor
+{
+public:
+
+    void Update(glm::vec3 position, glm::vec3 velocity, glm::vec3 gravity, float time);
+    void Invalidate();
+
+    bool IsValid() const;
+    float GetTime() const;
+    uint32_t GetNumSlots() const;
+    const BallPredictionSlot& GetSlot(uint32_t index) const;
+
+    glm::vec3 GetPosition(float timeAhead) const;
+    glm::vec3 GetVelocity(float timeAhead) const;
+
+    // Earliest time the ball could be reached by something at fromPosition moving at speed,
+    // looking at most maxTime ahead. Returns < 0 if never.
+    float FindReachTime(glm::vec3 fromPosition, float speed, float maxTime = BALL_PREDICTION_TIME) const;
+
+    void SetArenaSdf(const ArenaSdf* sdf);
+
+protected:
+
+    void Resimulate(glm::vec3 position, glm::vec3 velocity, float time);
+    void Extend();
+    bool Matches(glm::vec3 position, glm::vec3 velocity, float time) const;
+    void Sample(float time, glm::vec3& outPosition, glm::vec3& outVelocity) const;
+
+    BallPredictionSlot mSlots[BALL_PREDICTION_SLOTS];
+    BallPhysicsState mTailState;
+    uint32_t mHead = 0;
+    uint32_t mCount = 0;
+    float mTime = 0.0f;
+    glm::vec3 mGravity = { 0.0f, -9.8f, 0.0f };
+    const ArenaSdf* mArenaSdf = nullptr;
+};
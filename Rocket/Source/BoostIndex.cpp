@@ -0,0 +1,180 @@
+#include "BoostIndex.h"
+#include "BoostPickup.h"
+
+#include "Log.h"
+#include "Assertion.h"
+
+// Fuel a pad has to be worth per unit of detour.
+const float BoostDetourFuelCost = 0.5f;
+
+void BoostIndex::Build(BoostPickup* const* pickups, uint32_t numPickups)
+{
+    Clear();
+
+    if (numPickups > BOOST_INDEX_MAX_PADS)
+    {
+        LogWarning("Too many boost pads (%d), only indexing %d", numPickups, BOOST_INDEX_MAX_PADS);
+        numPickups = BOOST_INDEX_MAX_PADS;
+    }
+
+    uint16_t cellCounts[BOOST_INDEX_NUM_CELLS] = {};
+    int32_t padCells[BOOST_INDEX_MAX_PADS] = {};
+
+    for (uint32_t i = 0; i < numPickups; ++i)
+    {
+        BoostPad& pad = mPads[i];
+        pad.mPickup = pickups[i];
+        pad.mPosition = pickups[i]->GetPosition();
+        pad.mMini = pickups[i]->IsMini();
+        pad.mAmount = pickups[i]->GetBoostAmount();
+
+        int32_t x = 0;
+        int32_t z = 0;
+        GetCellCoords(pad.mPosition, x, z);
+        padCells[i] = z * BOOST_INDEX_DIM_X + x;
+        ++cellCounts[padCells[i]];
+    }
+
+    mNumPads = numPickups;
+
+    // Counting sort the pads into their cells.
+    uint16_t offset = 0;
+    for (int32_t c = 0; c < BOOST_INDEX_NUM_CELLS; ++c)
+    {
+        mCellStart[c] = offset;
+        offset += cellCounts[c];
+        cellCounts[c] = mCellStart[c];
+    }
+
+    mCellStart[BOOST_INDEX_NUM_CELLS] = offset;
+
+    for (uint32_t i = 0; i < mNumPads; ++i)
+    {
+        mCellPads[cellCounts[padCells[i]]++] = uint16_t(i);
+    }
+
+    Update();
+}
+
+void BoostIndex::Update()
+{
+    for (uint32_t i = 0; i < mNumPads; ++i)
+    {
+        mPads[i].mRespawnTime = mPads[i].mPickup->GetRespawnTime();
+    }
+}
+
+void BoostIndex::Clear()
+{
+    mNumPads = 0;
+
+    for (int32_t c = 0; c <= BOOST_INDEX_NUM_CELLS; ++c)
+    {
+        mCellStart[c] = 0;
+    }
+}
+
+uint32_t BoostIndex::GetNumPads() const
+{
+    return mNumPads;
+}
+
+const BoostPad& BoostIndex::GetPad(int32_t index) const
+{
+    OCT_ASSERT(index >= 0 && index < int32_t(mNumPads));
+    return mPads[index];
+}
+
+int32_t BoostIndex::FindPad(const BoostPickup* pickup) const
+{
+    for (uint32_t i = 0; i < mNumPads; ++i)
+    {
+        if (mPads[i].mPickup == pickup)
+        {
+            return int32_t(i);
+        }
+    }
+
+    return BOOST_INDEX_NONE;
+}
+
+bool BoostIndex::IsAvailableBy(int32_t index, float arrivalTime) const
+{
+    return index >= 0 &&
+        index < int32_t(mNumPads) &&
+        mPads[index].mRespawnTime <= arrivalTime;
+}
+
+int32_t BoostIndex::FindBest(const BoostQuery& query) const
+{
+    glm::vec3 from = glm::vec3(query.mFrom.x, 0.0f, query.mFrom.z);
+    glm::vec3 to = glm::vec3(query.mTo.x, 0.0f, query.mTo.z);
+    float routeDist = glm::distance(from, to);
+    float maxDetour = query.mMaxDetour;
+    float speed = glm::max(query.mSpeed, 0.01f);
+
+    // Every point within maxDetour of the route lies in an ellipse around it. Search the cells
+    // covering the route's box grown by the ellipse's semi-minor axis.
+    float margin = 0.5f * glm::sqrt(maxDetour * (2.0f * routeDist + maxDetour));
+    int32_t minX = 0;
+    int32_t minZ = 0;
+    int32_t maxX = 0;
+    int32_t maxZ = 0;
+    GetCellCoords(glm::min(from, to) - margin, minX, minZ);
+    GetCellCoords(glm::max(from, to) + margin, maxX, maxZ);
+
+    int32_t best = BOOST_INDEX_NONE;
+    float bestScore = 0.0f;
+
+    for (int32_t z = minZ; z <= maxZ; ++z)
+    {
+        for (int32_t x = minX; x <= maxX; ++x)
+        {
+            int32_t cell = z * BOOST_INDEX_DIM_X + x;
+
+            for (uint16_t p = mCellStart[cell]; p < mCellStart[cell + 1]; ++p)
+            {
+                int32_t index = mCellPads[p];
+                const BoostPad& pad = mPads[index];
+
+                if ((query.mFullOnly && pad.mMini) ||
+                    (query.mClaims != nullptr && query.mClaims[index] != nullptr && query.mClaims[index] != query.mCar))
+                {
+                    continue;
+                }
+
+                glm::vec3 padPos = glm::vec3(pad.mPosition.x, 0.0f, pad.mPosition.z);
+                float toPad = glm::distance(from, padPos);
+                float detour = toPad + glm::distance(padPos, to) - routeDist;
+
+                // Time spent waiting for the pad to come back costs as much as driving that long.
+                float arrivalTime = toPad / speed;
+                float waitTime = glm::max(pad.mRespawnTime - arrivalTime, 0.0f);
+                float cost = detour + waitTime * speed;
+
+                if (cost > maxDetour)
+                {
+                    continue;
+                }
+
+                float score = glm::min(pad.mAmount, query.mFuelNeeded) - cost * BoostDetourFuelCost;
+
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best = index;
+                }
+            }
+        }
+    }
+
+    return best;
+}
+
+void BoostIndex::GetCellCoords(glm::vec3 position, int32_t& outX, int32_t& outZ) const
+{
+    outX = int32_t((position.x + ARENA_EXTENT_X) / BOOST_INDEX_CELL_SIZE);
+    outZ = int32_t((position.z + ARENA_EXTENT_Z) / BOOST_INDEX_CELL_SIZE);
+    outX = glm::clamp(outX, 0, BOOST_INDEX_DIM_X - 1);
+    outZ = glm::clamp(outZ, 0, BOOST_INDEX_DIM_Z - 1);
+}
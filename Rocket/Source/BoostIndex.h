@@ -0,0 +1,79 @@
+#pragma once
+
+#include "RocketConstants.h"
+
+#include <stdint.h>
+#include <glm/glm.hpp>
+
+class BoostPickup;
+class Car;
+
+#define BOOST_INDEX_MAX_PADS 128
+#define BOOST_INDEX_CELL_SIZE 16.0f
+#define BOOST_INDEX_NONE -1
+#define BOOST_INDEX_DIM_X (int32_t(2.0f * ARENA_EXTENT_X / BOOST_INDEX_CELL_SIZE) + 1)
+#define BOOST_INDEX_DIM_Z (int32_t(2.0f * ARENA_EXTENT_Z / BOOST_INDEX_CELL_SIZE) + 1)
+#define BOOST_INDEX_NUM_CELLS (BOOST_INDEX_DIM_X * BOOST_INDEX_DIM_Z)
+
+struct BoostPad
+{
+    glm::vec3 mPosition = {};
+    BoostPickup* mPickup = nullptr;
+    float mAmount = 0.0f;
+
+    // Seconds until the pad is back, 0 if it's up now.
+    float mRespawnTime = 0.0f;
+    bool mMini = true;
+};
+
+struct BoostQuery
+{
+    glm::vec3 mFrom = {};
+    glm::vec3 mTo = {};
+
+    // Expected travel speed, used to estimate when each pad is reached.
+    float mSpeed = 1.0f;
+
+    // Extra distance (including time spent waiting for a pad to respawn) the car is willing to go.
+    float mMaxDetour = 0.0f;
+    float mFuelNeeded = 100.0f;
+    bool mFullOnly = false;
+
+    // Pads claimed by other cars are skipped. Indexed like the pads, may be null.
+    Car* const* mClaims = nullptr;
+    const Car* mCar = nullptr;
+};
+
+// Every boost pad in the arena (full and mini), bucketed on a coarse XZ grid.
+// Pad respawn times are snapshotted once per frame by the MatchState so bots can read them from any thread,
+// and "best pad on the way" queries only visit the cells near the route.
+class BoostIndex
+{
+public:
+
+    void Build(BoostPickup* const* pickups, uint32_t numPickups);
+    void Update();
+    void Clear();
+
+    uint32_t GetNumPads() const;
+    const BoostPad& GetPad(int32_t index) const;
+    int32_t FindPad(const BoostPickup* pickup) const;
+
+    // Whether the pad will be up by the time something arriving in arrivalTime seconds gets there.
+    bool IsAvailableBy(int32_t index, float arrivalTime) const;
+
+    // Pad with the best fuel gained for its detour from the straight route between query.mFrom and query.mTo.
+    // Returns BOOST_INDEX_NONE if no pad is worth the detour.
+    int32_t FindBest(const BoostQuery& query) const;
+
+protected:
+
+    void GetCellCoords(glm::vec3 position, int32_t& outX, int32_t& outZ) const;
+
+    BoostPad mPads[BOOST_INDEX_MAX_PADS];
+    uint32_t mNumPads = 0;
+
+    // Pads sorted by cell. Cell i owns mCellPads[mCellStart[i]] up to mCellPads[mCellStart[i + 1]].
+    uint16_t mCellStart[BOOST_INDEX_NUM_CELLS + 1] = {};
+    uint16_t mCellPads[BOOST_INDEX_MAX_PADS] = {};
+};
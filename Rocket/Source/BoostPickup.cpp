@@ -1,5 +1,6 @@
 #include "BoostPickup.h"
 #include "Car.h"
+#include "GameState.h"
 #include "Log.h"
 
 #include "AudioManager.h"
@@ -60,7 +61,7 @@ void BoostPickup::Tick(float deltaTime)
     if (NetIsAuthority() &&
         mSpawnTime > 0.0f)
     {
-        mSpawnTime -= deltaTime;
+        mSpawnTime -= GetSimFrameTime(deltaTime);
 
         if (mSpawnTime <= 0.0f)
         {
@@ -76,7 +77,7 @@ void BoostPickup::BeginOverlap(Primitive3D* thisComp, Primitive3D* otherComp)
         otherComp->Is(Car::ClassRuntimeId()))
     {
         Car* car = (Car*)otherComp;
-        car->AddBoostFuel(mMini ? 10.0f : 100.0f);
+        car->AddBoostFuel(GetBoostAmount());
 
         SetAlive(false);
     }
@@ -133,6 +134,21 @@ bool BoostPickup::IsMini() const
     return mMini;
 }
 
+bool BoostPickup::IsAlive() const
+{
+    return mAlive;
+}
+
+float BoostPickup::GetBoostAmount() const
+{
+    return mMini ? 10.0f : 100.0f;
+}
+
+float BoostPickup::GetRespawnTime() const
+{
+    return mAlive ? 0.0f : glm::max(mSpawnTime, 0.0f);
+}
+
 void BoostPickup::Reset()
 {
     SetAlive(true);
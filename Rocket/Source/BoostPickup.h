@@ -23,6 +23,9 @@ public:
     bool IsMini() const;
     void SetMini(bool mini);
     void SetAlive(bool alive);
+    bool IsAlive() const;
+    float GetBoostAmount() const;
+    float GetRespawnTime() const;
     void Reset();
 
 protected:
@@ -0,0 +1,119 @@
+#include "BotBlackboard.h"
+#include "MatchState.h"
+#include "Car.h"
+#include "Ball.h"
+
+#include <float.h>
+
+void BotBlackboard::Update(uint32_t team, MatchState* match)
+{
+    mTeam = team;
+    mForwardDir = (team == 0) ? glm::vec3(1, 0, 0) : glm::vec3(-1, 0, 0);
+
+    uint32_t enemyTeam = (team + 1) % NUM_TEAMS;
+    mOwnGoalPosition = match->mGoalBoxes[team] ? match->mGoalBoxes[team]->GetPosition() : glm::vec3(0.0f);
+    mEnemyGoalPosition = match->mGoalBoxes[enemyTeam] ? match->mGoalBoxes[enemyTeam]->GetPosition() : glm::vec3(0.0f);
+
+    mBallPosition = match->mBall ? match->mBall->GetSimPosition() : glm::vec3(0.0f);
+    mBallVelocity = match->mBallPredictor.IsValid() ? match->mBallPredictor.GetVelocity(0.0f) : glm::vec3(0.0f);
+
+    for (uint32_t i = 0; i < BOOST_INDEX_MAX_PADS; ++i)
+    {
+        mBoostClaims[i] = nullptr;
+    }
+
+    // Rebuild claims from what each bot is currently targeting.
+    mBallClaim = nullptr;
+    mBallClaimDistance = FLT_MAX;
+    mThreatCar = nullptr;
+    mThreatDistance = FLT_MAX;
+    float closestTeamDistance = FLT_MAX;
+
+    for (uint32_t i = 0; i < match->mNumCars; ++i)
+    {
+        Car* car = match->mCars[i];
+
+        if (car == nullptr ||
+            !car->IsAlive())
+        {
+            continue;
+        }
+
+        float distToBall = glm::distance(car->GetPosition(), mBallPosition);
+
+        if (car->GetTeamIndex() != int32_t(team))
+        {
+            if (distToBall < mThreatDistance)
+            {
+                mThreatCar = car;
+                mThreatDistance = distToBall;
+            }
+
+            continue;
+        }
+
+        closestTeamDistance = glm::min(closestTeamDistance, distToBall);
+
+        if (!car->IsBot())
+        {
+            continue;
+        }
+
+        if (car->GetBotTargetType() == BotTargetType::Ball)
+        {
+            ClaimBall(car, distToBall);
+        }
+        else if (car->GetBotTargetType() == BotTargetType::Boost)
+        {
+            ClaimBoost(car, car->GetBotTargetBoost());
+        }
+    }
+
+    bool ballInOwnHalf = (glm::dot(mBallPosition, mForwardDir) < 0.0f);
+    mUnderThreat = ballInOwnHalf && (mThreatDistance < closestTeamDistance);
+}
+
+bool BotBlackboard::IsBallClaimedByOther(const Car* car, float distToBall) const
+{
+    return mBallClaim != nullptr &&
+        mBallClaim != car &&
+        mBallClaimDistance <= distToBall;
+}
+
+void BotBlackboard::ClaimBall(Car* car, float distToBall)
+{
+    // The closest claimant keeps the ball.
+    if (mBallClaim == nullptr ||
+        mBallClaim == car ||
+        distToBall < mBallClaimDistance)
+    {
+        mBallClaim = car;
+        mBallClaimDistance = distToBall;
+    }
+}
+
+void BotBlackboard::ClaimBoost(Car* car, int32_t boostIndex)
+{
+    if (boostIndex >= 0 &&
+        boostIndex < BOOST_INDEX_MAX_PADS)
+    {
+        mBoostClaims[boostIndex] = car;
+    }
+}
+
+void BotBlackboard::ReleaseClaims(const Car* car)
+{
+    if (mBallClaim == car)
+    {
+        mBallClaim = nullptr;
+        mBallClaimDistance = FLT_MAX;
+    }
+
+    for (uint32_t i = 0; i < BOOST_INDEX_MAX_PADS; ++i)
+    {
+        if (mBoostClaims[i] == car)
+        {
+            mBoostClaims[i] = nullptr;
+        }
+    }
+}
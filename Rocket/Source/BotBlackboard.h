@@ -0,0 +1,46 @@
+#pragma once
+
+#include "RocketConstants.h"
+#include "BoostIndex.h"
+
+#include <stdint.h>
+#include <glm/glm.hpp>
+
+class Car;
+class MatchState;
+
+// What a team's bots know about the match this tick. Rebuilt once per tick by the MatchState
+// so every bot on the team reads the same shared values instead of recomputing them.
+// Claims record which teammate is going for the ball or a boost so two bots don't chase the same thing.
+class BotBlackboard
+{
+public:
+
+    void Update(uint32_t team, MatchState* match);
+
+    bool IsBallClaimedByOther(const Car* car, float distToBall) const;
+    void ClaimBall(Car* car, float distToBall);
+    void ClaimBoost(Car* car, int32_t boostIndex);
+    void ReleaseClaims(const Car* car);
+
+    uint32_t mTeam = 0;
+
+    // Direction this team attacks in.
+    glm::vec3 mForwardDir = {};
+    glm::vec3 mOwnGoalPosition = {};
+    glm::vec3 mEnemyGoalPosition = {};
+
+    glm::vec3 mBallPosition = {};
+    glm::vec3 mBallVelocity = {};
+    Car* mBallClaim = nullptr;
+    float mBallClaimDistance = 0.0f;
+
+    // Indexed like MatchState::mBoostIndex pads.
+    Car* mBoostClaims[BOOST_INDEX_MAX_PADS] = {};
+
+    // Opponent closest to the ball. The team is under threat when they are closer to it
+    // than any of our cars while the ball is in our half.
+    Car* mThreatCar = nullptr;
+    float mThreatDistance = 0.0f;
+    bool mUnderThreat = false;
+};
@@ -0,0 +1,312 @@
+#include "BotDecisionTable.h"
+
+#include "Stream.h"
+#include "Log.h"
+#include "Assertion.h"
+
+#include "System/System.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <glm/glm.hpp>
+
+// How steep a >= or < consideration is. Anything more than 1 / this past the threshold fully passes.
+const float BotDecisionStepSharpness = 1000.0f;
+const uint32_t BotDecisionMaxLine = 128;
+
+static const char* sBehaviorNames[] = { "Defense", "Offense", "Support" };
+static const char* sGoalNames[] = { "Ball", "Boost", "FrontOfBall", "NearBall", "OwnGoal" };
+static const char* sFactorNames[] =
+{
+    "BallDistance",
+    "BallForward",
+    "BallAlign",
+    "BallClaimed",
+    "BallSide",
+    "UnderThreat",
+    "BoostFuel",
+    "BoostFound",
+    "TargetTime",
+    "TargetDistance",
+    "TargetAvailable"
+};
+
+static_assert(sizeof(sBehaviorNames) / sizeof(sBehaviorNames[0]) == uint32_t(BotBehavior::Count), "Missing behavior name");
+static_assert(sizeof(sGoalNames) / sizeof(sGoalNames[0]) == uint32_t(BotGoal::Count), "Missing goal name");
+static_assert(sizeof(sFactorNames) / sizeof(sFactorNames[0]) == uint32_t(BotFactor::Count), "Missing factor name");
+
+static int32_t FindName(const char* name, const char* const* names, uint32_t numNames)
+{
+    for (uint32_t i = 0; i < numNames; ++i)
+    {
+        if (strcmp(name, names[i]) == 0)
+        {
+            return int32_t(i);
+        }
+    }
+
+    return -1;
+}
+
+int32_t BotDecisionTable::Evaluate(const float* factors, BotGoal currentGoal) const
+{
+    int32_t best = BOT_DECISION_NONE;
+    float bestScore = 0.0f;
+
+    for (uint32_t r = 0; r < mNumRules; ++r)
+    {
+        // Hold rules are zeroed unless their goal is the one being pursued.
+        float score = mWeights[r] * (1.0f - mHold[r] * float(mGoals[r] != currentGoal));
+
+        for (uint32_t c = mFirst[r]; c < mFirst[r + 1]; ++c)
+        {
+            float response = factors[mFactors[c]] * mScales[c] + mOffsets[c];
+            score *= glm::clamp(response, 0.0f, 1.0f);
+        }
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = int32_t(r);
+        }
+    }
+
+    return best;
+}
+
+bool BotDecisionTable::IsHold(int32_t rule) const
+{
+    OCT_ASSERT(rule >= 0 && rule < int32_t(mNumRules));
+    return mHold[rule] != 0.0f;
+}
+
+bool BotDecisions::Load(const char* path)
+{
+    if (!SYS_DoesFileExist(path, true))
+    {
+        LogError("Bot decisions %s not found, bots will all head for their own goal", path);
+        OCT_ASSERT(0);
+        Clear();
+        return false;
+    }
+
+    Stream stream;
+    stream.ReadFile(path, true);
+
+    if (!Compile(stream.GetData(), stream.GetSize(), path))
+    {
+        LogError("Bot decisions %s failed to compile, bots will all head for their own goal", path);
+        OCT_ASSERT(0);
+        Clear();
+        return false;
+    }
+
+    return true;
+}
+
+void BotDecisions::Clear()
+{
+    mTables.clear();
+    mTableNames.clear();
+
+    for (uint32_t i = 0; i < uint32_t(BotBehavior::Count); ++i)
+    {
+        mBehaviorTables[i] = -1;
+    }
+}
+
+int32_t BotDecisions::FindTable(const char* name) const
+{
+    for (uint32_t i = 0; i < mTableNames.size(); ++i)
+    {
+        if (mTableNames[i] == name)
+        {
+            return int32_t(i);
+        }
+    }
+
+    return -1;
+}
+
+const BotDecisionTable& BotDecisions::GetTable(int32_t index) const
+{
+    // No rules, so Evaluate() never picks anything.
+    static const BotDecisionTable sEmptyTable;
+
+    if (index < 0 || index >= int32_t(mTables.size()))
+    {
+        return sEmptyTable;
+    }
+
+    return mTables[index];
+}
+
+const BotDecisionTable& BotDecisions::GetTable(BotBehavior behavior) const
+{
+    OCT_ASSERT(behavior != BotBehavior::Count);
+    return GetTable(mBehaviorTables[uint32_t(behavior)]);
+}
+
+bool BotDecisions::Compile(const char* text, uint32_t length, const char* name)
+{
+    // Compile into scratch tables so a bad file leaves the current ones alone.
+    std::vector<BotDecisionTable> tables;
+    std::vector<std::string> tableNames;
+    int32_t table = -1;
+
+    uint32_t pos = 0;
+    uint32_t lineNumber = 0;
+
+    while (pos < length)
+    {
+        char line[BotDecisionMaxLine] = {};
+        uint32_t lineLength = 0;
+
+        while (pos < length && text[pos] != '\n')
+        {
+            if (lineLength < BotDecisionMaxLine - 1)
+            {
+                line[lineLength++] = text[pos];
+            }
+
+            ++pos;
+        }
+
+        ++pos;
+        ++lineNumber;
+
+        char* comment = strchr(line, '#');
+        if (comment != nullptr)
+        {
+            *comment = 0;
+        }
+
+        char word[32] = {};
+        char arg[32] = {};
+        char op[8] = {};
+        float valueA = 0.0f;
+        float valueB = 0.0f;
+        int32_t numRead = sscanf(line, "%31s %31s %7s %f %f", word, arg, op, &valueA, &valueB);
+
+        if (numRead <= 0)
+        {
+            continue;
+        }
+
+        if (strcmp(word, "behavior") == 0 && numRead >= 2)
+        {
+            // Behaviors are named by the data. Naming one again adds more rules to it.
+            table = int32_t(std::find(tableNames.begin(), tableNames.end(), arg) - tableNames.begin());
+
+            if (table == int32_t(tables.size()))
+            {
+                tables.push_back(BotDecisionTable());
+                tableNames.push_back(arg);
+            }
+
+            continue;
+        }
+
+        if (table < 0)
+        {
+            LogWarning("Bot decisions %s:%d: expected a behavior first", name, lineNumber);
+            return false;
+        }
+
+        BotDecisionTable& rules = tables[table];
+
+        if ((strcmp(word, "pick") == 0 || strcmp(word, "hold") == 0) && numRead >= 3)
+        {
+            int32_t goal = FindName(arg, sGoalNames, uint32_t(BotGoal::Count));
+
+            // The weight must be the only thing after the goal.
+            float weight = 0.0f;
+            char trailing[2] = {};
+            bool weightRead = (sscanf(line, "%*s %*s %f %1s", &weight, trailing) == 1);
+
+            if (goal < 0 || !weightRead || rules.mNumRules >= BOT_DECISION_MAX_RULES)
+            {
+                LogWarning("Bot decisions %s:%d: bad rule", name, lineNumber);
+                return false;
+            }
+
+            uint32_t rule = rules.mNumRules++;
+            rules.mGoals[rule] = BotGoal(goal);
+            rules.mWeights[rule] = weight;
+            rules.mHold[rule] = (word[0] == 'h') ? 1.0f : 0.0f;
+            rules.mFirst[rule] = uint16_t(rules.mFactors.size());
+            rules.mFirst[rule + 1] = rules.mFirst[rule];
+        }
+        else if (strcmp(word, "consider") == 0 && numRead >= 4 && rules.mNumRules > 0)
+        {
+            int32_t factor = FindName(arg, sFactorNames, uint32_t(BotFactor::Count));
+
+            if (factor < 0)
+            {
+                LogWarning("Bot decisions %s:%d: unknown factor %s", name, lineNumber, arg);
+                return false;
+            }
+
+            float scale = 0.0f;
+            float offset = 0.0f;
+
+            if (strcmp(op, "ramp") == 0 && numRead >= 5 && valueB != valueA)
+            {
+                scale = 1.0f / (valueB - valueA);
+                offset = -valueA * scale;
+            }
+            else if (strcmp(op, ">=") == 0)
+            {
+                scale = BotDecisionStepSharpness;
+                offset = 1.0f - valueA * BotDecisionStepSharpness;
+            }
+            else if (strcmp(op, "<") == 0)
+            {
+                scale = -BotDecisionStepSharpness;
+                offset = valueA * BotDecisionStepSharpness;
+            }
+            else
+            {
+                LogWarning("Bot decisions %s:%d: bad consideration", name, lineNumber);
+                return false;
+            }
+
+            rules.mFactors.push_back(uint8_t(factor));
+            rules.mScales.push_back(scale);
+            rules.mOffsets.push_back(offset);
+            rules.mFirst[rules.mNumRules] = uint16_t(rules.mFactors.size());
+        }
+        else
+        {
+            LogWarning("Bot decisions %s:%d: can't parse \"%s\"", name, lineNumber, line);
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < tables.size(); ++i)
+    {
+        if (tables[i].mNumRules == 0)
+        {
+            LogWarning("Bot decisions %s: no rules for %s", name, tableNames[i].c_str());
+            return false;
+        }
+    }
+
+    mTables = tables;
+    mTableNames = tableNames;
+
+    // Bots are given a BotBehavior, match each one to the table of the same name.
+    for (uint32_t i = 0; i < uint32_t(BotBehavior::Count); ++i)
+    {
+        mBehaviorTables[i] = FindTable(sBehaviorNames[i]);
+
+        if (mBehaviorTables[i] < 0)
+        {
+            LogWarning("Bot decisions %s: no behavior %s, its bots will head for their own goal", name, sBehaviorNames[i]);
+        }
+    }
+
+    return true;
+}
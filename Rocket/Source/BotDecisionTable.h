@@ -0,0 +1,97 @@
+#pragma once
+
+#include "RocketTypes.h"
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+
+#define BOT_DECISION_MAX_RULES 32
+#define BOT_DECISION_NONE -1
+
+// What a bot can decide to go after. Ball and Boost target actors, the rest pick a position.
+enum class BotGoal
+{
+    Ball,
+    Boost,
+    FrontOfBall,
+    NearBall,
+    OwnGoal,
+
+    Count
+};
+
+// Inputs gathered once per think and shared by every rule.
+enum class BotFactor
+{
+    BallDistance,
+    BallForward,
+    BallAlign,
+    BallClaimed,
+    BallSide,
+    UnderThreat,
+    BoostFuel,
+    BoostFound,
+    TargetTime,
+    TargetDistance,
+    TargetAvailable,
+
+    Count
+};
+
+// One compiled behavior. A rule scores mWeight times the product of its considerations, each one
+// a linear response of a factor clamped to [0, 1]. "Pick" rules choose a new target for their goal,
+// "hold" rules only score while their goal is the current one and keep the target as it is.
+// The highest scoring rule wins, so a hold that outweighs the picks makes the bot stick to its target.
+struct BotDecisionTable
+{
+    uint32_t mNumRules = 0;
+    BotGoal mGoals[BOT_DECISION_MAX_RULES] = {};
+    float mWeights[BOT_DECISION_MAX_RULES] = {};
+    float mHold[BOT_DECISION_MAX_RULES] = {};
+
+    // Rule i owns considerations mFirst[i] up to mFirst[i + 1].
+    uint16_t mFirst[BOT_DECISION_MAX_RULES + 1] = {};
+
+    std::vector<uint8_t> mFactors;
+    std::vector<float> mScales;
+    std::vector<float> mOffsets;
+
+    // Index of the winning rule, or BOT_DECISION_NONE if nothing scored above zero.
+    int32_t Evaluate(const float* factors, BotGoal currentGoal) const;
+    bool IsHold(int32_t rule) const;
+};
+
+// Decision tables compiled from a text asset, one per named behavior. Each line is one of:
+//   behavior <Name>
+//   pick <Goal> <weight>
+//   hold <Goal> <weight>
+//   consider <Factor> >= <value>
+//   consider <Factor> < <value>
+//   consider <Factor> ramp <from> <to>
+// Considerations belong to the rule above them, '#' starts a comment.
+// Behavior names are up to the data, a BotBehavior uses the table with its name if there is one.
+class BotDecisions
+{
+public:
+
+    BotDecisions() { Clear(); }
+
+    bool Load(const char* path);
+    void Clear();
+
+    // Index of the named table, or -1.
+    int32_t FindTable(const char* name) const;
+
+    // A missing table is empty, so its bots never pick a rule.
+    const BotDecisionTable& GetTable(int32_t index) const;
+    const BotDecisionTable& GetTable(BotBehavior behavior) const;
+
+protected:
+
+    bool Compile(const char* text, uint32_t length, const char* name);
+
+    std::vector<BotDecisionTable> mTables;
+    std::vector<std::string> mTableNames;
+    int32_t mBehaviorTables[uint32_t(BotBehavior::Count)];
+};
@@ -0,0 +1,228 @@
+#include "BotPlanner.h"
+#include "ArenaSdf.h"
+#include "TaskPool.h"
+#include "RocketTypes.h"
+
+#include "Maths.h"
+
+const float PlanSteerValues[] = { -1.0f, -0.5f, 0.0f, 0.5f, 1.0f };
+const uint32_t NumPlanSteerValues = sizeof(PlanSteerValues) / sizeof(PlanSteerValues[0]);
+
+// Scoring. Touches always beat misses; among touches, sooner and toward the enemy goal is better.
+const float PlanTouchScore = 1000.0f;
+const float PlanTouchTimeWeight = 200.0f;
+const float PlanGoalAlignWeight = 300.0f;
+const float PlanBoostWeight = 0.1f;
+
+// Collision for rollouts. Uses the arena SDF when it covers the sweep, otherwise the arena bounds.
+// Only reads shared data, so any number of rollouts can run at once.
+class BotRolloutQuery : public CarCollisionQuery
+{
+public:
+
+    virtual bool Sweep(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, CarSweepResult& outResult) override
+    {
+        if (mArenaSdf != nullptr &&
+            mArenaSdf->Contains(start) &&
+            mArenaSdf->Contains(end))
+        {
+            return mArenaSdf->SweepSphere(start, end, mRadius, outResult);
+        }
+
+        return SweepBounds(start, end, outResult);
+    }
+
+    virtual uint32_t SweepContacts(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, CarSweepResult* outContacts, uint32_t maxContacts) override
+    {
+        return (maxContacts > 0 && Sweep(start, end, collisionMask, outContacts[0])) ? 1 : 0;
+    }
+
+    virtual float GetClearance(glm::vec3 position) const override
+    {
+        return (mArenaSdf != nullptr && mArenaSdf->Contains(position)) ? (mArenaSdf->GetDistance(position) - mRadius) : FLT_MAX;
+    }
+
+    virtual uint8_t GetCollisionMask() const override
+    {
+        return ColGroupEnvironment;
+    }
+
+    bool SweepBounds(glm::vec3 start, glm::vec3 end, CarSweepResult& outResult) const
+    {
+        const glm::vec3 minBounds = glm::vec3(-ARENA_EXTENT_X, 0.0f, -ARENA_EXTENT_Z) + mRadius;
+        const glm::vec3 maxBounds = glm::vec3(ARENA_EXTENT_X, ARENA_EXTENT_Y, ARENA_EXTENT_Z) - mRadius;
+
+        outResult = CarSweepResult();
+        outResult.mPosition = end;
+        outResult.mContactType = CarContactType::Environment;
+
+        glm::vec3 delta = end - start;
+        float hitFraction = 1.0f;
+        glm::vec3 hitNormal = {};
+
+        for (uint32_t axis = 0; axis < 3; ++axis)
+        {
+            if (end[axis] < minBounds[axis] && delta[axis] < 0.0f)
+            {
+                float t = glm::max((minBounds[axis] - start[axis]) / delta[axis], 0.0f);
+                if (t < hitFraction)
+                {
+                    hitFraction = t;
+                    hitNormal = {};
+                    hitNormal[axis] = 1.0f;
+                }
+            }
+            else if (end[axis] > maxBounds[axis] && delta[axis] > 0.0f)
+            {
+                float t = glm::max((maxBounds[axis] - start[axis]) / delta[axis], 0.0f);
+                if (t < hitFraction)
+                {
+                    hitFraction = t;
+                    hitNormal = {};
+                    hitNormal[axis] = -1.0f;
+                }
+            }
+        }
+
+        if (hitNormal == glm::vec3(0.0f))
+        {
+            return false;
+        }
+
+        outResult.mPosition = start + delta * hitFraction;
+        outResult.mHitPosition = outResult.mPosition - hitNormal * mRadius;
+        outResult.mHitNormal = hitNormal;
+        outResult.mHitFraction = hitFraction;
+        return true;
+    }
+
+    const ArenaSdf* mArenaSdf = nullptr;
+    float mRadius = 1.0f;
+};
+
+const CarInput& BotPlan::GetInput(float time) const
+{
+    int32_t segment = int32_t(time / (BOT_PLAN_HORIZON / BOT_PLAN_SEGMENTS));
+    segment = glm::clamp<int32_t>(segment, 0, BOT_PLAN_SEGMENTS - 1);
+    return mInputs[segment];
+}
+
+const BotPlan& BotPlanner::Plan(const BotPlanRequest& request, TaskPool* pool)
+{
+    mRequest = request;
+    mRequest.mNumRollouts = glm::clamp<uint32_t>(mRequest.mNumRollouts, 1, BOT_PLAN_MAX_ROLLOUTS);
+
+    GenerateCandidates();
+
+    if (pool != nullptr)
+    {
+        pool->Dispatch(RolloutTask, this, mRequest.mNumRollouts);
+        pool->Wait();
+    }
+    else
+    {
+        for (uint32_t i = 0; i < mRequest.mNumRollouts; ++i)
+        {
+            Rollout(i);
+        }
+    }
+
+    mBestPlan = mCandidates[0];
+
+    for (uint32_t i = 1; i < mRequest.mNumRollouts; ++i)
+    {
+        if (mCandidates[i].mScore > mBestPlan.mScore)
+        {
+            mBestPlan = mCandidates[i];
+        }
+    }
+
+    return mBestPlan;
+}
+
+const BotPlan& BotPlanner::GetBestPlan() const
+{
+    return mBestPlan;
+}
+
+void BotPlanner::RolloutTask(void* data, uint32_t index)
+{
+    BotPlanner* planner = (BotPlanner*)data;
+    planner->Rollout(index);
+}
+
+void BotPlanner::GenerateCandidates()
+{
+    uint32_t seed = mRequest.mSeed * 747796405u + 2891336453u;
+
+    for (uint32_t i = 0; i < mRequest.mNumRollouts; ++i)
+    {
+        BotPlan& plan = mCandidates[i];
+        plan = BotPlan();
+
+        for (uint32_t s = 0; s < BOT_PLAN_SEGMENTS; ++s)
+        {
+            CarInput& input = plan.mInputs[s];
+            input.mAccelerate = 1.0f;
+
+            if (i < NumPlanSteerValues * 2)
+            {
+                // The first candidates always cover holding each steer value, with and without boost.
+                input.mMotionX = PlanSteerValues[i % NumPlanSteerValues];
+                input.mBoost = (i >= NumPlanSteerValues);
+            }
+            else
+            {
+                seed = seed * 1664525u + 1013904223u;
+                uint32_t bits = (seed >> 8);
+
+                input.mMotionX = PlanSteerValues[bits % NumPlanSteerValues];
+                input.mBoost = (bits & 0x100) != 0;
+                input.mSlide = (fabs(input.mMotionX) == 1.0f) && ((bits & 0x600) == 0);
+
+                // Only jump later in the plan so the car still has time to line up.
+                input.mJump = (s > 0) && ((bits & 0x1800) == 0);
+            }
+        }
+    }
+}
+
+void BotPlanner::Rollout(uint32_t index)
+{
+    BotPlan& plan = mCandidates[index];
+    CarPhysicsState state = mRequest.mCarState;
+
+    BotRolloutQuery query;
+    query.mArenaSdf = mRequest.mArenaSdf;
+    query.mRadius = mRequest.mCarRadius;
+
+    const float contactDistance = mRequest.mCarRadius + BALL_RADIUS;
+    const uint32_t numSteps = uint32_t(BOT_PLAN_HORIZON / BOT_PLAN_STEP + 0.5f);
+    float minDistance = FLT_MAX;
+
+    for (uint32_t i = 0; i < numSteps; ++i)
+    {
+        float time = (i + 1) * BOT_PLAN_STEP;
+        CarPhysics::Step(state, plan.GetInput(time - BOT_PLAN_STEP), BOT_PLAN_STEP, &query);
+
+        glm::vec3 ballPos = mRequest.mBallPredictor.GetPosition(time);
+        float distance = glm::distance(state.mPosition, ballPos);
+
+        if (distance <= contactDistance)
+        {
+            glm::vec3 hitDir = Maths::SafeNormalize(ballPos - state.mPosition);
+            glm::vec3 goalDir = Maths::SafeNormalize(mRequest.mEnemyGoalPosition - ballPos);
+
+            plan.mTouchTime = time;
+            plan.mScore = PlanTouchScore -
+                PlanTouchTimeWeight * time +
+                PlanGoalAlignWeight * glm::dot(hitDir, goalDir) +
+                PlanBoostWeight * state.mBoostFuel;
+            return;
+        }
+
+        minDistance = glm::min(minDistance, distance);
+    }
+
+    plan.mScore = -minDistance;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CarPhysics.h"
+#include "BallPredictor.h"
+
+#include <stdint.h>
+#include <float.h>
+#include <glm/glm.hpp>
+
+class ArenaSdf;
+class TaskPool;
+
+#define BOT_PLAN_HORIZON 1.0f
+#define BOT_PLAN_STEP (1.0f / 30.0f)
+#define BOT_PLAN_SEGMENTS 2
+#define BOT_PLAN_MAX_ROLLOUTS 64
+#define BOT_PLAN_DEFAULT_ROLLOUTS 24
+
+// A candidate input sequence: BOT_PLAN_SEGMENTS inputs held for equal parts of the horizon.
+struct BotPlan
+{
+    CarInput mInputs[BOT_PLAN_SEGMENTS];
+    float mScore = -FLT_MAX;
+
+    // When the rollout touched the ball, or < 0 if it never did.
+    float mTouchTime = -1.0f;
+
+    bool TouchesBall() const { return mTouchTime >= 0.0f; }
+    const CarInput& GetInput(float time) const;
+};
+
+// Everything a plan needs, copied so that the rollouts never touch live nodes.
+struct BotPlanRequest
+{
+    CarPhysicsState mCarState;
+    float mCarRadius = 1.0f;
+    glm::vec3 mEnemyGoalPosition = {};
+    BallPredictor mBallPredictor;
+    const ArenaSdf* mArenaSdf = nullptr;
+    uint32_t mNumRollouts = BOT_PLAN_DEFAULT_ROLLOUTS;
+    uint32_t mSeed = 0;
+};
+
+// Picks bot inputs by simulating candidate input sequences with the headless car kernel against
+// the predicted ball path and keeping the best scoring one. More rollouts make for a stronger bot.
+class BotPlanner
+{
+public:
+
+    // Runs the rollouts, spread across the pool's workers if one is given, and returns the best plan.
+    const BotPlan& Plan(const BotPlanRequest& request, TaskPool* pool);
+    const BotPlan& GetBestPlan() const;
+
+protected:
+
+    static void RolloutTask(void* data, uint32_t index);
+    void GenerateCandidates();
+    void Rollout(uint32_t index);
+
+    BotPlanRequest mRequest;
+    BotPlan mCandidates[BOT_PLAN_MAX_ROLLOUTS];
+    BotPlan mBestPlan;
+};
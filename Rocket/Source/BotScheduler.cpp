@@ -0,0 +1,99 @@
+#include "BotScheduler.h"
+#include "Car.h"
+#include "GameState.h"
+
+#include "System/System.h"
+
+// Think interval, prediction horizon, rollouts
+const BotBudget BotTierBudgets[] =
+{
+    { 0.4f, 1.0f, 0 },                                      // Rookie
+    { 0.1f, 2.0f, 16 },                                     // Pro
+    { 0.05f, BALL_PREDICTION_TIME, BOT_PLAN_MAX_ROLLOUTS }, // AllStar
+};
+
+static_assert(sizeof(BotTierBudgets) / sizeof(BotTierBudgets[0]) == uint32_t(BotDifficulty::Count), "Missing bot tier budget");
+
+BotBudget GetBotTierBudget(BotDifficulty difficulty)
+{
+    uint32_t tier = glm::min(uint32_t(difficulty), uint32_t(BotDifficulty::Count) - 1);
+    BotBudget budget = BotTierBudgets[tier];
+
+    // No planner on weak platforms, and think less often.
+    if (SYS_GetPlatformTier() < 1)
+    {
+        budget.mThinkInterval *= 2.0f;
+        budget.mPredictionHorizon = glm::min(budget.mPredictionHorizon, 1.5f);
+        budget.mNumRollouts = 0;
+    }
+
+    return budget;
+}
+
+void BotScheduler::Reset()
+{
+    for (uint32_t i = 0; i < MAX_CARS; ++i)
+    {
+        mTimeSinceThink[i] = 0.0f;
+    }
+
+    mNextCar = 0;
+    mSpentBudget = 0.0f;
+
+    // Spare cores take the planner rollouts, so each one buys more thinking per frame.
+    mFrameBudget = (SYS_GetPlatformTier() < 1) ? BOT_FRAME_BUDGET_LOW : BOT_FRAME_BUDGET;
+    mFrameBudget += BOT_FRAME_BUDGET_PER_WORKER * GetGameState()->mTaskPool.GetNumThreads();
+}
+
+void BotScheduler::Update(Car* const* cars, uint32_t numCars, float deltaTime)
+{
+    mSpentBudget = 0.0f;
+
+    if (numCars == 0)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < numCars; ++i)
+    {
+        mTimeSinceThink[i] += deltaTime;
+    }
+
+    // Start from where the last frame left off so every bot gets its turn when the budget runs out.
+    uint32_t numThinks = 0;
+    uint32_t start = mNextCar % numCars;
+
+    for (uint32_t n = 0; n < numCars; ++n)
+    {
+        uint32_t i = (start + n) % numCars;
+        Car* car = cars[i];
+
+        if (car == nullptr ||
+            !car->IsBot() ||
+            mTimeSinceThink[i] < car->GetBotBudget().mThinkInterval)
+        {
+            continue;
+        }
+
+        // Rollouts only cost anything when the planner actually runs.
+        float cost = GetThinkCost(GetMatchState()->mBotPlanning ? car->GetBotRolloutBudget() : 0);
+
+        // Always let one bot through so an expensive tier can't be starved by a small budget.
+        if (numThinks > 0 &&
+            mSpentBudget + cost > mFrameBudget)
+        {
+            break;
+        }
+
+        car->RequestBotThink();
+        mTimeSinceThink[i] = 0.0f;
+        mNextCar = i + 1;
+        mSpentBudget += cost;
+        ++numThinks;
+    }
+}
+
+float BotScheduler::GetThinkCost(uint32_t numRollouts)
+{
+    return BOT_THINK_COST + numRollouts / BOT_ROLLOUTS_PER_COST;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "RocketConstants.h"
+#include "RocketTypes.h"
+
+#include <stdint.h>
+
+class Car;
+
+// Frame budget is in think cost units: one target selection, plus one per BOT_ROLLOUTS_PER_COST planner rollouts.
+#define BOT_THINK_COST 1.0f
+#define BOT_ROLLOUTS_PER_COST 8.0f
+#define BOT_FRAME_BUDGET 4.0f
+#define BOT_FRAME_BUDGET_LOW 2.0f
+#define BOT_FRAME_BUDGET_PER_WORKER 3.0f
+
+// How much compute a bot of a given difficulty gets.
+struct BotBudget
+{
+    // Seconds between target selections.
+    float mThinkInterval = 0.1f;
+
+    // How far ahead on the predicted ball path the bot looks for an intercept.
+    float mPredictionHorizon = 2.0f;
+
+    // Candidate plans evaluated by the BotPlanner per think (when MatchState::mBotPlanning is on).
+    uint32_t mNumRollouts = 0;
+};
+
+// Budget for a difficulty tier, reduced to fit the platform.
+BotBudget GetBotTierBudget(BotDifficulty difficulty);
+
+// Spreads bot thinking across frames within a per-frame compute budget. Each frame, bots that have waited
+// at least their tier's think interval are told to re-evaluate their target, taking turns in car order,
+// until the frame budget is spent. The budget is smaller on weak platforms and grows with TaskPool workers.
+// Steering still runs every tick from each bot's cached target.
+class BotScheduler
+{
+public:
+
+    void Reset();
+    void Update(Car* const* cars, uint32_t numCars, float deltaTime);
+
+    static float GetThinkCost(uint32_t numRollouts);
+
+    float mFrameBudget = BOT_FRAME_BUDGET;
+    float mSpentBudget = 0.0f;
+
+protected:
+
+    float mTimeSinceThink[MAX_CARS] = {};
+    uint32_t mNextCar = 0;
+};
@@ -1,7 +1,9 @@
 #define _CRT_SECURE_NO_WARNINGS 1
 
 #include "Car.h"
+#include "CarPhysics.h"
 #include "Ball.h"
+#include "BoostPickup.h"
 #include "RocketTypes.h"
 #include "GameState.h"
 
@@ -24,26 +26,16 @@
 const float CameraHeight = 2.0f;
 const float CameraDistanceXZ = 6.5f;
 const float CameraSpeed = 800.0f;
-const float SpeedLimit = 20.0f;
-const float BoostSpeedLimit = 40.0f;
-const float BoostDepletionSpeed = 50.0f;
-const float StartingBoost = 35.0f;
-const float DefaultGravity = 9.8f;
-const float WallGravity = 8 * 9.8f;
-const float JumpSpeed = 8.0f;
-const float SpinJumpSpeed = JumpSpeed * 2.0f;
-const float DefaultAcceleration = 30.0f;
-const float BoostAcceleration = DefaultAcceleration;
-const float AerialBoostAcceleration = DefaultAcceleration * 0.8f;
-const float DoubleJumpTimeLimit = 2.0f;
-const float DoubleJumpSpinDuration = 0.8f;
-const float GroundedTurnRate = 2.0f;
-const float SlideTurnRate = 3.0f * GroundedTurnRate;
-const float AerialTurnRate = GroundedTurnRate;
 const float DemoSpeedReq = 35.0f;
 const float DemoSpeedDiff = 5.0f;
+const float PoseAlwaysRelevantDist = 8.0f;
+const float PoseRelevantCos = 0.25f;
+const float BallCamLookAhead = 0.1f;
+const float BotBoostMaxDetour = 80.0f;
+const float BotAerialFollowThrough = 0.25f;
 
 const glm::vec3 RootRelativeShadowPos = glm::vec3(0.0f, -2.3f, 0.0f);
+const glm::quat ShadowWorldRotation = glm::quat(0.0f, 1.0f, 0.0f, 0.0f); // 180 degrees about X
 
 DEFINE_NODE(Car, Sphere3D);
 
@@ -171,14 +163,15 @@ void Car::C_ForceTransform(Node* node, Datum& vecPosition, Datum& vecRotation)
     glm::vec3 rotation = vecRotation.GetVector();
     car->SetPosition(position);
     car->SetRotation(rotation);
+    car->ResetInterpolation();
 }
 
 void Car::C_AddBoostFuel(Node* node, Datum& fBoostFuel)
 {
     Car* car = (Car*)node;
     float boostFuel = fBoostFuel.GetFloat();
-    car->mBoostFuel += boostFuel;
-    car->mBoostFuel = glm::clamp(car->mBoostFuel, 0.0f, 100.0f);
+    car->mPhysics.mBoostFuel += boostFuel;
+    car->mPhysics.mBoostFuel = glm::clamp(car->mPhysics.mBoostFuel, 0.0f, 100.0f);
 
     if (car->IsLocallyControlled())
     {
@@ -200,6 +193,295 @@ void Car::M_Demolish(Node* node)
     car->mDemoComponent->EnableEmission(true);
 }
 
+static CarContactType GetContactType(Node* hitNode)
+{
+    CarContactType contactType = CarContactType::Environment;
+
+    if (hitNode != nullptr)
+    {
+        if (hitNode->Is(Ball::ClassRuntimeId()))
+        {
+            contactType = CarContactType::Ball;
+        }
+        else if (hitNode->Is(Car::ClassRuntimeId()))
+        {
+            contactType = CarContactType::Car;
+        }
+    }
+
+    return contactType;
+}
+
+bool CarNodeCollisionQuery::Sweep(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, CarSweepResult& outResult)
+{
+    const ArenaSdf* sdf = GetArenaSdf(start, end, collisionMask);
+
+    if (sdf == nullptr)
+    {
+        return SweepWorld(start, end, collisionMask, outResult);
+    }
+
+    // Environment from the SDF, then everything else through Bullet up to where the environment stopped us.
+    bool hit = sdf->SweepSphere(start, end, mCar->GetRadius(), outResult);
+
+    uint8_t nodeMask = (collisionMask & (~ColGroupEnvironment));
+    if (nodeMask != 0)
+    {
+        CarSweepResult nodeResult;
+        if (SweepWorld(start, outResult.mPosition, nodeMask, nodeResult))
+        {
+            nodeResult.mHitFraction *= outResult.mHitFraction;
+            outResult = nodeResult;
+            hit = true;
+        }
+    }
+
+    return hit;
+}
+
+uint32_t CarNodeCollisionQuery::SweepContacts(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, CarSweepResult* outContacts, uint32_t maxContacts)
+{
+    const ArenaSdf* sdf = GetArenaSdf(start, end, collisionMask);
+
+    if (sdf == nullptr)
+    {
+        return SweepWorldContacts(start, end, collisionMask, outContacts, maxContacts);
+    }
+
+    uint8_t nodeMask = (collisionMask & (~ColGroupEnvironment));
+    uint32_t numContacts = 0;
+
+    if (nodeMask != 0)
+    {
+        numContacts = SweepWorldContacts(start, end, nodeMask, outContacts, maxContacts);
+    }
+
+    CarSweepResult envResult;
+    bool envHit = sdf->SweepSphere(start, end, mCar->GetRadius(), envResult);
+
+    // Nothing past the environment hit matters, so it may push the last contact off of a full list.
+    if (envHit &&
+        (numContacts < maxContacts || envResult.mHitFraction < outContacts[maxContacts - 1].mHitFraction))
+    {
+        uint32_t insertIndex = glm::min(numContacts, maxContacts - 1);
+        while (insertIndex > 0 && outContacts[insertIndex - 1].mHitFraction > envResult.mHitFraction)
+        {
+            outContacts[insertIndex] = outContacts[insertIndex - 1];
+            --insertIndex;
+        }
+
+        outContacts[insertIndex] = envResult;
+        numContacts = glm::min(numContacts + 1, maxContacts);
+    }
+
+    return numContacts;
+}
+
+const ArenaSdf* CarNodeCollisionQuery::GetArenaSdf(glm::vec3 start, glm::vec3 end, uint8_t collisionMask) const
+{
+    MatchState* match = GetMatchState();
+
+    if (match != nullptr &&
+        (collisionMask & ColGroupEnvironment) &&
+        match->mArenaSdf.Contains(start) &&
+        match->mArenaSdf.Contains(end))
+    {
+        return &match->mArenaSdf;
+    }
+
+    return nullptr;
+}
+
+bool CarNodeCollisionQuery::SweepWorld(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, CarSweepResult& outResult)
+{
+    if (mCar->GetPosition() != start)
+    {
+        mCar->SetPosition(start);
+    }
+
+    SweepTestResult sweepResult;
+    bool hit = mCar->SweepToWorldPosition(end, sweepResult, collisionMask);
+
+    outResult.mPosition = mCar->GetPosition();
+    outResult.mHitPosition = sweepResult.mHitPosition;
+    outResult.mHitNormal = sweepResult.mHitNormal;
+    outResult.mHitFraction = sweepResult.mHitFraction;
+    outResult.mHitNode = sweepResult.mHitNode;
+    outResult.mContactType = GetContactType(sweepResult.mHitNode);
+
+    return hit;
+}
+
+// Records the earliest hit against each object instead of only the closest overall,
+// so one convexSweepTest() can answer what the ball, cars and environment did along the path.
+struct CarContactsCallback : public btCollisionWorld::ConvexResultCallback
+{
+    struct Contact
+    {
+        const btCollisionObject* mObject;
+        btVector3 mPoint;
+        btVector3 mNormal;
+        btScalar mFraction;
+    };
+
+    virtual bool needsCollision(btBroadphaseProxy* proxy0) const override
+    {
+        if (proxy0->m_clientObject == mIgnoreObject)
+        {
+            return false;
+        }
+
+        return ConvexResultCallback::needsCollision(proxy0);
+    }
+
+    virtual btScalar addSingleResult(btCollisionWorld::LocalConvexResult& convexResult, bool normalInWorldSpace) override
+    {
+        const btCollisionObject* object = convexResult.m_hitCollisionObject;
+        btVector3 normal = normalInWorldSpace ?
+            convexResult.m_hitNormalLocal :
+            object->getWorldTransform().getBasis() * convexResult.m_hitNormalLocal;
+
+        uint32_t index = 0;
+        while (index < mNumContacts && mContacts[index].mObject != object)
+        {
+            ++index;
+        }
+
+        if (index == mNumContacts)
+        {
+            if (mNumContacts == CAR_MAX_SWEEP_CONTACTS)
+            {
+                return m_closestHitFraction;
+            }
+
+            mContacts[mNumContacts++].mFraction = BT_LARGE_FLOAT;
+        }
+
+        Contact& contact = mContacts[index];
+        if (convexResult.m_hitFraction < contact.mFraction)
+        {
+            contact.mObject = object;
+            contact.mPoint = convexResult.m_hitPointLocal;
+            contact.mNormal = normal;
+            contact.mFraction = convexResult.m_hitFraction;
+        }
+
+        // Don't shrink m_closestHitFraction, we want everything along the path.
+        return m_closestHitFraction;
+    }
+
+    const btCollisionObject* mIgnoreObject = nullptr;
+    Contact mContacts[CAR_MAX_SWEEP_CONTACTS] = {};
+    uint32_t mNumContacts = 0;
+};
+
+uint32_t CarNodeCollisionQuery::SweepWorldContacts(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, CarSweepResult* outContacts, uint32_t maxContacts)
+{
+    btDynamicsWorld* dynamicsWorld = mCar->GetWorld()->GetDynamicsWorld();
+    btSphereShape sphereShape(mCar->GetRadius());
+
+    btTransform startTransform;
+    btTransform endTransform;
+    startTransform.setIdentity();
+    endTransform.setIdentity();
+    startTransform.setOrigin(btVector3(start.x, start.y, start.z));
+    endTransform.setOrigin(btVector3(end.x, end.y, end.z));
+
+    CarContactsCallback callback;
+    callback.mIgnoreObject = mCar->GetRigidBody();
+    callback.m_collisionFilterGroup = mCar->GetCollisionGroup();
+    callback.m_collisionFilterMask = collisionMask;
+
+    dynamicsWorld->convexSweepTest(&sphereShape, startTransform, endTransform, callback);
+
+    // Insertion sort by fraction, there are only ever a handful of contacts.
+    uint32_t numContacts = 0;
+    for (uint32_t i = 0; i < callback.mNumContacts && numContacts < maxContacts; ++i)
+    {
+        const CarContactsCallback::Contact& contact = callback.mContacts[i];
+        float fraction = (float)contact.mFraction;
+
+        CarSweepResult result;
+        result.mPosition = glm::mix(start, end, fraction);
+        result.mHitPosition = glm::vec3(contact.mPoint.x(), contact.mPoint.y(), contact.mPoint.z());
+        result.mHitNormal = glm::vec3(contact.mNormal.x(), contact.mNormal.y(), contact.mNormal.z());
+        result.mHitFraction = fraction;
+        result.mHitNode = (Primitive3D*)contact.mObject->getUserPointer();
+        result.mContactType = GetContactType(result.mHitNode);
+
+        uint32_t insertIndex = numContacts;
+        while (insertIndex > 0 && outContacts[insertIndex - 1].mHitFraction > fraction)
+        {
+            outContacts[insertIndex] = outContacts[insertIndex - 1];
+            --insertIndex;
+        }
+
+        outContacts[insertIndex] = result;
+        ++numContacts;
+    }
+
+    return numContacts;
+}
+
+float CarNodeCollisionQuery::GetClearance(glm::vec3 position) const
+{
+    const ArenaSdf* sdf = GetArenaSdf(position, position, ColGroupEnvironment);
+    return (sdf != nullptr) ? (sdf->GetDistance(position) - mCar->GetRadius()) : FLT_MAX;
+}
+
+uint8_t CarNodeCollisionQuery::GetCollisionMask() const
+{
+    uint8_t collisionMask = mCar->GetCollisionMask();
+
+    // Car pairs are resolved by the match's spatial hash instead.
+    MatchState* match = GetMatchState();
+    if (match != nullptr &&
+        match->IsCarBroadphaseActive())
+    {
+        collisionMask = (collisionMask & (~ColGroupCar));
+    }
+
+    return collisionMask;
+}
+
+bool CarNodeCollisionQuery::GetBallMotion(CarBallMotion& outMotion)
+{
+    // Only the authority simulates the ball, clients keep finding touches with the sweep.
+    MatchState* match = GetMatchState();
+    Ball* ball = (match != nullptr) ? match->mBall : nullptr;
+
+    if (!NetIsAuthority() ||
+        ball == nullptr ||
+        !ball->IsAlive())
+    {
+        return false;
+    }
+
+    ball->GetStepMotion(outMotion.mPosition, outMotion.mVelocity);
+    outMotion.mRadius = BALL_RADIUS;
+    outMotion.mContactDistance = BALL_RADIUS + mCar->GetRadius();
+    outMotion.mNode = ball;
+    return true;
+}
+
+void CarNodeCollisionQuery::OnBallImpact(const CarBallMotion& motion, float impactTime)
+{
+    // The ball steps after the cars, so the touch is replayed at its exact time when it does.
+    Ball* ball = static_cast<Ball*>(motion.mNode);
+    ball->AddImpact(motion.mVelocity, impactTime);
+}
+
+void CarNodeCollisionQuery::OnContact(CarPhysicsState& state, const CarSweepResult& result)
+{
+    // Environment contacts from the arena SDF have no node (and need no handling beyond grounding).
+    if (result.mHitNode == nullptr)
+    {
+        return;
+    }
+
+    mCar->HandleCollision(mCar, static_cast<Primitive3D*>(result.mHitNode), result.mHitPosition, result.mHitNormal, nullptr);
+}
+
 Car::Car()
 {
     mReplicate = true;
@@ -207,6 +489,8 @@ Car::Car()
     // Handle transform ourselves since we want to skip replication updates for locally controlled cars.
     mReplicateTransform = false;
     mLateTick = true;
+
+    mCollisionQuery.mCar = this;
 }
 
 Car::~Car()
@@ -315,24 +599,27 @@ void Car::Tick(float deltaTime)
 {
     Sphere3D::Tick(deltaTime);
 
-    if (IsLocallyControlled() ||
-        (NetIsAuthority() && IsBot()))
+    if (IsSimulatedLocally())
     {
-        if (IsBot())
-        {
-            UpdateBotInput(deltaTime);
-        }
-        else
+        // Match cars are polled and stepped together by MatchState::UpdateSimulation().
+        if (!IsSteppedByMatch())
         {
-            UpdateInput(deltaTime);
+            UpdateControlInput(GetSimFrameTime(deltaTime));
+
+            float stepTime = deltaTime;
+            uint32_t numSteps = GetSimSteps(deltaTime, stepTime);
+
+            for (uint32_t i = 0; i < numSteps; ++i)
+            {
+                BeginPhysicsStep(stepTime);
+                CarPhysics::UpdateBoost(mPhysics, mCurrentInput, stepTime);
+                CarPhysics::UpdateVelocity(mPhysics, mCurrentInput, stepTime);
+                EndPhysicsStep(stepTime);
+            }
         }
 
-        UpdateBoost(deltaTime);
-        UpdateRotation(deltaTime);
-        UpdateVelocity(deltaTime);
-        UpdateJump(deltaTime);
-        UpdateMotion(deltaTime);
-        UpdateGrounded(deltaTime);
+        UpdateVisualTransform();
+        UpdateMeshPose(deltaTime);
         UpdateDebug(deltaTime);
         UpdateCamera(deltaTime);
 
@@ -340,26 +627,49 @@ void Car::Tick(float deltaTime)
             NetIsClient())
         {
             // Upload our new transform to the server
-            InvokeNetFunc("S_UploadState", GetPosition(), GetRotationEuler(), mVelocity, mBoosting);
+            InvokeNetFunc("S_UploadState", GetPosition(), GetRotationEuler(), mPhysics.mVelocity, mPhysics.mBoosting);
         }
     }
-    else if (NetIsAuthority() &&
-        !IsLocallyControlled())
+
+    if (!IsSimulatedLocally())
     {
-        // Update motion on client cars to determine demolition/bumps/ballhits.
-        UpdateMotion(deltaTime);
+        // Transform comes straight from replication / uploads, nothing to interpolate.
+        ResetInterpolation();
+        UpdateVisualTransform();
     }
 
     if (NetIsAuthority())
     {
-        UpdateRespawn(deltaTime);
+        UpdateRespawn(GetSimFrameTime(deltaTime));
     }
 
     UpdateAudio(deltaTime);
 
-    mShadowComponent->SetWorldRotation(glm::vec3(180.0f, 0.0f, 0.0f));
-    // TODO-NODE: Shouldn't the following line call SetPosition() instead of SetWorldPosition()
-    mShadowComponent->SetWorldPosition(GetPosition() + RootRelativeShadowPos);
+    UpdateShadowTransform();
+}
+
+void Car::UpdateShadowTransform()
+{
+    glm::vec3 position = GetPosition();
+    glm::quat rotation = GetRotationQuat();
+
+    if (position == mShadowParentPosition &&
+        rotation == mShadowParentRotation &&
+        mVisualPosition == mShadowVisualPosition)
+    {
+        return;
+    }
+
+    mShadowParentPosition = position;
+    mShadowParentRotation = rotation;
+    mShadowVisualPosition = mVisualPosition;
+
+    // The shadow cone points straight down under the visual position regardless of the car's rotation.
+    // Set its relative transform directly (car is spawned under the scene root) instead of
+    // SetWorldRotation() + SetWorldPosition(), which each rebuild the car's matrix.
+    glm::quat invRotation = glm::inverse(rotation);
+    mShadowComponent->SetPosition(invRotation * (mVisualPosition + RootRelativeShadowPos - position));
+    mShadowComponent->SetRotation(invRotation * ShadowWorldRotation);
 }
 
 void Car::GatherReplicatedData(std::vector<NetDatum>& outData)
@@ -381,7 +691,7 @@ void Car::GatherReplicatedData(std::vector<NetDatum>& outData)
     outData.push_back(NetDatum(DatumType::Integer, this, &mTeamIndex, 1, OnRep_TeamIndex));
     outData.push_back(NetDatum(DatumType::Bool, this, &mControlEnabled, 1, nullptr, true));
     outData.push_back(NetDatum(DatumType::Bool, this, &mAlive, 1, OnRep_Alive, true));
-    outData.push_back(NetDatum(DatumType::Bool, this, &mBoosting, 1 , OnRep_Boosting, true));
+    outData.push_back(NetDatum(DatumType::Bool, this, &mPhysics.mBoosting, 1 , OnRep_Boosting, true));
 }
 
 void Car::GatherNetFuncs(std::vector<NetFunc>& outFuncs)
@@ -403,28 +713,7 @@ void Car::HandleCollision(
     glm::vec3 impactNormal,
     btPersistentManifold* manifold)
 {
-
-    float landingDot = glm::dot(GetUpVector(), impactNormal);
-    if (impactNormal.y > -0.5f &&
-        landingDot > 0.5f)
-    {
-        mGrounded = true;
-        mDoubleJump = true;
-        mSurfaceAligned = true;
-        mTimeSinceLastGrounding = 0.0f;
-        mSurfaceNormal = impactNormal;
-    }
-    else if (impactNormal.y > 0.5f)
-    {
-        // In the case that we aren't aligned but we hit something that is mostly a floor,
-        // we still want to update the surface normal and begin to flip the car upright.
-        mSurfaceNormal = impactNormal;
-        mGrounded = true;
-        mDoubleJump = true;
-        mSurfaceAligned = false;
-        mTimeSinceLastGrounding = 0.0f;
-    }
-
+    // Grounding is resolved by CarPhysics::HandleContact() before this is called.
     bool bumped = false;
 
     if (otherComp->Is(Ball::ClassRuntimeId()))
@@ -435,39 +724,49 @@ void Car::HandleCollision(
     }
     else if (otherComp->Is(Car::ClassRuntimeId()))
     {
-        Car* otherCar = static_cast<Car*>(otherComp);
+        HandleCarContact(static_cast<Car*>(otherComp), impactNormal);
+    }
 
-        float thisDot = fabs(glm::dot(impactNormal, mVelocity));
-        float otherDot = fabs(glm::dot(impactNormal, otherCar->GetVelocity()));
+    if (bumped &&
+        !GetGameState()->mHeadless)
+    {
+        AudioManager::PlaySound3D(mBumpSound.Get<SoundWave>(), GetPosition(), 3.0f, 30.0f);
+    }
+}
 
-        if (NetIsAuthority() &&
-            mTeamIndex != otherCar->GetTeamIndex() &&
-            thisDot > DemoSpeedReq &&
-            thisDot > (otherDot + DemoSpeedDiff))
-        {
-            // Demo
-            otherCar->Kill();
+void Car::HandleCarContact(Car* otherCar, glm::vec3 impactNormal)
+{
+    float thisDot = fabs(glm::dot(impactNormal, mPhysics.mVelocity));
+    float otherDot = fabs(glm::dot(impactNormal, otherCar->GetVelocity()));
 
-            // Play demo particle
-            otherCar->InvokeNetFunc("M_Demolish");
-        }
-        else
+    if (NetIsAuthority() &&
+        mTeamIndex != otherCar->GetTeamIndex() &&
+        thisDot > DemoSpeedReq &&
+        thisDot > (otherDot + DemoSpeedDiff))
+    {
+        // Demo
+        otherCar->Kill();
+
+        // Play demo particle
+        otherCar->InvokeNetFunc("M_Demolish");
+
+        GetGameState()->mSelfPlay.RecordDemo(mTeamIndex);
+    }
+    else
+    {
+        // Bump
+        if (NetIsAuthority())
         {
-            // Bump
-            if (NetIsAuthority())
-            {
-                float newSpeed = (glm::length(mVelocity) + glm::length(otherCar->GetVelocity())) / 2.0f;
-                newSpeed = glm::max(newSpeed, 20.0f);
-                ForceVelocity(newSpeed * impactNormal);
-                otherCar->ForceVelocity(newSpeed * -impactNormal);
-            }
-            bumped = true;
+            float newSpeed = (glm::length(mPhysics.mVelocity) + glm::length(otherCar->GetVelocity())) / 2.0f;
+            newSpeed = glm::max(newSpeed, 20.0f);
+            ForceVelocity(newSpeed * impactNormal);
+            otherCar->ForceVelocity(newSpeed * -impactNormal);
         }
-    }
 
-    if (bumped)
-    {
-        AudioManager::PlaySound3D(mBumpSound.Get<SoundWave>(), GetPosition(), 3.0f, 30.0f);
+        if (!GetGameState()->mHeadless)
+        {
+            AudioManager::PlaySound3D(mBumpSound.Get<SoundWave>(), GetPosition(), 3.0f, 30.0f);
+        }
     }
 }
 
@@ -491,23 +790,52 @@ void Car::Reset()
     Respawn();
 
     mBotTargetType = BotTargetType::Count;
+    mBotGoal = BotGoal::Count;
+    mBotAerialActive = false;
 }
 
 void Car::SetVelocity(glm::vec3 velocity)
 {
-    mVelocity = velocity;
+    mPhysics.mVelocity = velocity;
 }
 
 glm::vec3 Car::GetVelocity() const
 {
-    return mVelocity;
+    return mPhysics.mVelocity;
+}
+
+const CarPhysicsState& Car::GetPhysicsState() const
+{
+    return mPhysics;
+}
+
+CarPhysicsState& Car::GetPhysicsState()
+{
+    return mPhysics;
+}
+
+const CarInput& Car::GetCurrentInput() const
+{
+    return mCurrentInput;
+}
+
+bool Car::IsSimulatedLocally() const
+{
+    return IsLocallyControlled() ||
+        (NetIsAuthority() && IsBot());
+}
+
+bool Car::IsSteppedByMatch() const
+{
+    MatchState* match = GetMatchState();
+    return (match != nullptr && match->IsCarSteppedByMatch(this));
 }
 
 void Car::ForceVelocity(glm::vec3 velocity)
 {
     OCT_ASSERT(NetIsAuthority());
     SetVelocity(velocity);
-    InvokeNetFunc("C_ForceVelocity", mVelocity);
+    InvokeNetFunc("C_ForceVelocity", mPhysics.mVelocity);
 }
 
 bool Car::IsBot() const
@@ -530,14 +858,72 @@ BotBehavior Car::GetBotBehavior() const
     return mBotBehavior;
 }
 
+BotTargetType Car::GetBotTargetType() const
+{
+    return mBotTargetType;
+}
+
+Node3D* Car::GetBotTargetActor() const
+{
+    return mBotTargetActor;
+}
+
+int32_t Car::GetBotTargetBoost() const
+{
+    return mBotTargetBoost;
+}
+
 void Car::ForceBotTargetBall()
 {
+    // Don't change the target under a decision that is still running.
+    GetMatchState()->FinishBotDecisions();
+
     mBotTargetType = BotTargetType::Ball;
+    mBotGoal = BotGoal::Ball;
     mBotTargetActor = GetMatchState()->mBall;
+    mBotTargetBoost = BOOST_INDEX_NONE;
+    mBotAerialActive = false;
     mBotTargetPosition = {};
     mBotTargetTime = 0.0f;
 }
 
+void Car::RequestBotThink()
+{
+    mBotThinkRequested = true;
+}
+
+void Car::SetBotRolloutBudget(uint32_t numRollouts)
+{
+    mBotRolloutBudget = numRollouts;
+}
+
+uint32_t Car::GetBotRolloutBudget() const
+{
+    return mBotRolloutBudget;
+}
+
+void Car::SetBotDifficulty(BotDifficulty difficulty)
+{
+    mBotDifficulty = difficulty;
+    mBotBudget = GetBotTierBudget(difficulty);
+    SetBotRolloutBudget(mBotBudget.mNumRollouts);
+}
+
+BotDifficulty Car::GetBotDifficulty() const
+{
+    return mBotDifficulty;
+}
+
+void Car::SetBotSeed(uint32_t seed)
+{
+    mBotSeed = seed;
+}
+
+const BotBudget& Car::GetBotBudget() const
+{
+    return mBotBudget;
+}
+
 int32_t Car::GetCarIndex() const
 {
     return mCarIndex;
@@ -587,7 +973,7 @@ void Car::AddBoostFuel(float boost)
 
 float Car::GetBoostFuel() const
 {
-    return mBoostFuel;
+    return mPhysics.mBoostFuel;
 }
 
 void Car::Kill()
@@ -610,6 +996,11 @@ void Car::Kill()
     }
 }
 
+bool Car::IsAlive() const
+{
+    return mAlive;
+}
+
 void Car::Respawn()
 {
     OCT_ASSERT(NetIsAuthority());
@@ -650,18 +1041,82 @@ void Car::UpdateBotInput(float deltaTime)
 
     if (mControlEnabled)
     {
-        // (1) Acquire a target.
-        BotUpdateTarget(deltaTime);
+        // When decisions are parallel, this input was decided on a worker last frame (see MatchState::StartBotDecisions()).
+        if (!GetMatchState()->IsBotDecisionParallel())
+        {
+            BeginBotDecision(deltaTime);
+            BotDecide(&GetGameState()->mTaskPool);
+            EndBotDecision();
+        }
 
-        // (2) Adjust steering and acceleration
-        BotUpdateHandling(deltaTime);
+        mCurrentInput = mBotInputs[mBotInputFront];
     }
     else
     {
         mCurrentInput = {};
+        mBotInputs[mBotInputFront] = {};
     }
 }
 
+void Car::BeginBotDecision(float deltaTime)
+{
+    // Copy everything the decision reads about this car, so it can run while the car keeps simulating.
+    mBotView = mPhysics;
+    mBotView.mPosition = GetPosition();
+    mBotView.mRotation = GetRotationQuat();
+    mBotDecisionTime = deltaTime;
+    mBotThinking = mBotThinkRequested || (mBotTargetType == BotTargetType::Count);
+    mBotThinkRequested = false;
+    mBotRandom = (mBotSeed * 747796405u + 2891336453u) ^ (GetMatchState()->GetSimTick() * 2654435761u);
+}
+
+void Car::BotDecide(TaskPool* pool)
+{
+    CarInput& input = mBotInputs[1 - mBotInputFront];
+    mBotThinkTime += mBotDecisionTime;
+
+    // (1) Acquire a target. Only when scheduled, unless there is no target to steer toward.
+    if (mBotThinking)
+    {
+        BotUpdateTarget(mBotThinkTime);
+        BotUpdatePlan(pool);
+        BotUpdateAerial();
+        mBotThinkTime = 0.0f;
+    }
+
+    // (2) Adjust steering and acceleration
+    if (mBotAerialActive)
+    {
+        input = AerialSolver::GetInput(mBotAerial, mBotView, mBotAerialTime);
+        mBotAerialTime += mBotDecisionTime;
+
+        // Done once past the intercept, or if the car never got off the ground.
+        bool landed = mBotView.mGrounded && (mBotAerialTime > 2.0f * AERIAL_DOUBLE_JUMP_TIME + mBotDecisionTime);
+        mBotAerialActive = !landed && (mBotAerialTime < mBotAerial.mInterceptTime + BotAerialFollowThrough);
+    }
+    else if (mBotPlanActive)
+    {
+        input = mBotPlanner.GetBestPlan().GetInput(mBotPlanTime);
+        mBotPlanTime += mBotDecisionTime;
+        mBotPlanActive = (mBotPlanTime < BOT_PLAN_HORIZON);
+    }
+    else
+    {
+        BotUpdateHandling(mBotDecisionTime, input);
+    }
+}
+
+void Car::EndBotDecision()
+{
+    if (mBotThinking)
+    {
+        BotApplyClaims();
+        mBotThinking = false;
+    }
+
+    mBotInputFront = 1 - mBotInputFront;
+}
+
 void Car::UpdateInput(float deltaTime)
 {
     mPreviousInput = mCurrentInput;
@@ -738,150 +1193,96 @@ void Car::UpdateRespawn(float deltaTime)
     }
 }
 
-void Car::UpdateBoost(float deltaTime)
+void Car::UpdateControlInput(float deltaTime)
 {
-    if (mCurrentInput.mBoost &&
-        mBoostFuel > 0.0f)
+    if (IsBot())
     {
-        SetBoosting(true);
-
-        mBoostFuel -= deltaTime * BoostDepletionSpeed;
-        mBoostFuel = glm::max(mBoostFuel, 0.0f);
+        UpdateBotInput(deltaTime);
     }
     else
     {
-        SetBoosting(false);
+        UpdateInput(deltaTime);
     }
 }
 
-void Car::UpdateRotation(float deltaTime)
+void Car::BeginPhysicsStep(float deltaTime)
 {
-    float motionX = mCurrentInput.mMotionX;
-    float motionY = mCurrentInput.mMotionY;
-
-    // Account for deadzone
-    if (fabs(motionX) < 0.2f)
-    {
-        motionX = 0.0f;
-    }
-
-    if (fabs(motionY) < 0.2f)
-    {
-        motionY = 0.0f;
-    }
-
-    // Update turn rate
-    if (mGrounded && mSurfaceAligned && mCurrentInput.mSlide)
-    {
-        float slideDir = 0.0f;
+    mPhysics.mPosition = GetPosition();
+    mPhysics.mRotation = GetRotationQuat();
+    mStepWasBoosting = mPhysics.mBoosting;
 
-        if (motionX > 0.0f)
-            slideDir = -1.0f;
-        else if (motionX < 0.0f)
-            slideDir = 1.0f;
+    // Remember where this step started so the visuals can be blended toward the result.
+    mPrevPhysicsPosition = mPhysics.mPosition;
+    mPrevPhysicsRotation = mPhysics.mRotation;
 
-        bool reversing = mCurrentInput.mAccelerate < mCurrentInput.mReverse;
-        if (reversing)
-        {
-            slideDir *= -1.0f;
-        }
-
-        mSlideTurnRate = Maths::Approach(mSlideTurnRate, SlideTurnRate * slideDir, 2.0f, deltaTime);
-    }
-    else
-    {
-        mSlideTurnRate = Maths::Approach(mSlideTurnRate, 0.0f, 2.0f, deltaTime);
-    }
+    CarPhysics::BeginStep(mPhysics, mCurrentInput, deltaTime);
+}
 
-    float turnRate = (mGrounded && mSurfaceAligned) ? GroundedTurnRate : AerialTurnRate;
+void Car::EndPhysicsStep(float deltaTime)
+{
+    CarStepEvents events = CarPhysics::EndStep(mPhysics, mCurrentInput, deltaTime, &mCollisionQuery);
 
-    bool reversing =
-        mGrounded &&
-        mSurfaceAligned &&
-        glm::dot(mVelocity, GetForwardVector()) < 0.0f;
+    SetPosition(mPhysics.mPosition);
+    SetRotation(mPhysics.mRotation);
 
-    float rotX = 0.0f;
-    float rotY = 0.0f;
-    float rotZ = 0.0f;
-    if (!mGrounded)
+    if (mPhysics.mBoosting != mStepWasBoosting)
     {
-        if (mCurrentInput.mSlide)
-        {
-            rotZ = turnRate * -motionX * deltaTime;
-        }
-
-        rotX = turnRate * -motionY * deltaTime;
+        UpdateBoostEffects();
     }
 
-    if (mGrounded || !mCurrentInput.mSlide)
+    if (events.mJumped)
     {
-        rotY = turnRate * -motionX * deltaTime;
-
-        if (mGrounded)
-        {
-            // Shouldn't be able to turn when not moving
-            float speed = glm::length(mVelocity);
-            float turnAlpha = glm::clamp(speed / SpeedLimit, 0.0f, 1.0f);
-            turnAlpha = glm::max(glm::pow(turnAlpha, 0.5f) - 0.05f, 0.0f);
-            rotY *= turnAlpha;
-
-            if (speed > 0.1f && reversing)
-                rotY *= -1.0f;
-
-            rotY += mSlideTurnRate * deltaTime;
-        }
+        PlayJumpAudio();
     }
+}
 
-    if (!(mGrounded && mSurfaceAligned) &&
-        mSpinTime > 0.0f)
-    {
-        rotX = 0.0f;
-        rotY = 0.0f;
-        rotZ = 0.0f;
-    }
+void Car::ResetInterpolation()
+{
+    mPrevPhysicsPosition = GetPosition();
+    mPrevPhysicsRotation = GetRotationQuat();
+}
 
-    glm::quat quatRotX = glm::quat({ rotX, 0.0f, 0.0f });
-    glm::quat quatRotY = glm::quat({ 0.0f, rotY, 0.0f });
-    glm::quat quatRotZ = glm::quat({ 0.0f, 0.0f, rotZ});
-    glm::quat currentRot = GetRotationQuat();
-    SetRotation(currentRot * quatRotY * quatRotZ * quatRotX);
+void Car::UpdateVisualTransform()
+{
+    // Physics runs at a fixed rate, so blend the mesh between the last two steps
+    // based on how far the render time is into the next step.
+    MatchState* match = GetMatchState();
+    float alpha = (match != nullptr) ? match->GetSimAlpha() : 1.0f;
 
-    float speed = glm::length(mVelocity);
+    glm::vec3 position = GetPosition();
+    glm::quat rotation = GetRotationQuat();
 
-    if (mGrounded && mSurfaceAligned)
-    {
-        // Convert Forward Velocity
-        const float velocityConversionRate = mCurrentInput.mSlide ? 0.4f : 0.9f;
-        
-        glm::vec3 retainedVelocity = mVelocity * (1.0f - velocityConversionRate);
+    mVisualPosition = glm::mix(mPrevPhysicsPosition, position, alpha);
+    mVisualRotation = glm::slerp(mPrevPhysicsRotation, rotation, alpha);
 
-        mVelocity = (speed > 0.0f) ? glm::normalize(mVelocity) : mVelocity;
-        mVelocity = glm::rotate(mVelocity, rotY, glm::vec3(0.0f, 1.0f, 0.0f));
-        mVelocity *= (speed * velocityConversionRate);
-        mVelocity += retainedVelocity;
-    }
+    glm::quat invRotation = glm::inverse(rotation);
+    mMesh3D->SetPosition(invRotation * (mVisualPosition - position));
+    mMesh3D->SetRotation(invRotation * mVisualRotation);
+}
 
-    // Adjust front fender / wheel rotation to match input direction
+void Car::UpdateMeshPose(float deltaTime)
+{
     // NOTE: This function is only firing on local player or net authority, so clients
     // will not see other car wheel rotation or turning (hard to notice anyway). To fix this,
     // we can probably add replicated data for steering direction + speed.
-    float targetRotY = -30.0f * motionX;
-    mWheelRotationY = Maths::Approach(mWheelRotationY, targetRotY, 500.0f, deltaTime);
 
-    float wheelSpeed = -800.0f * glm::clamp(speed / 20.0f, 0.0f, 1.0f);
-    wheelSpeed *= glm::dot(mVelocity, GetForwardVector()) >= 0.0f ? 1.0f : -1.0f;
-    float deltaWheelAngle = wheelSpeed * deltaTime;
-    mWheelRotationX += deltaWheelAngle;
-    mWheelRotationX = fmod(mWheelRotationX, 360.0f);
+    // Wheel and fender state is kept up to date by the physics step regardless, so the pose
+    // can be rebuilt from scratch whenever the car comes back into view.
+    if (!IsPoseRelevant())
+    {
+        mSkippedPoseTime += deltaTime;
+        return;
+    }
 
     // Force an animation update so we can adjust bones afterwards.
     // Animation usually happens during the culling step before rendering,
     // But calling it here will do it ahead of time (and skip animation during culling).
-    mMesh3D->UpdateAnimation(deltaTime, true);
+    mMesh3D->UpdateAnimation(deltaTime + mSkippedPoseTime, true);
+    mSkippedPoseTime = 0.0f;
 
     {
         // Fender rotation (only adjust yaw)
-        glm::quat rotY = glm::quat(glm::vec3(0.0f, 0.0f, DEGREES_TO_RADIANS * mWheelRotationY));
+        glm::quat rotY = glm::quat(glm::vec3(0.0f, 0.0f, DEGREES_TO_RADIANS * mPhysics.mWheelRotationY));
         glm::mat4 fenderTransform = glm::toMat4(rotY);
 
         mMesh3D->SetBoneTransform(mBoneFenderL, fenderTransform);
@@ -890,8 +1291,8 @@ void Car::UpdateRotation(float deltaTime)
 
     {
         // Wheel rotation (adjust yaw and pitch)
-        glm::quat rotX = glm::quat(glm::vec3(DEGREES_TO_RADIANS * mWheelRotationX, 0.0f, 0.0f));
-        glm::quat rotY = glm::quat(glm::vec3(0.0f, 0.0f, DEGREES_TO_RADIANS * mWheelRotationY));
+        glm::quat rotX = glm::quat(glm::vec3(DEGREES_TO_RADIANS * mPhysics.mWheelRotationX, 0.0f, 0.0f));
+        glm::quat rotY = glm::quat(glm::vec3(0.0f, 0.0f, DEGREES_TO_RADIANS * mPhysics.mWheelRotationY));
         glm::quat rotQuat = rotY * rotX;
         glm::mat4 frontWheelTransform = glm::toMat4(rotQuat);
         glm::mat4 backWheelTransform = glm::toMat4(rotX);
@@ -903,186 +1304,31 @@ void Car::UpdateRotation(float deltaTime)
     }
 }
 
-void Car::UpdateVelocity(float deltaTime)
+bool Car::IsPoseRelevant() const
 {
-    // Update the speed limit. Increases when boost is held.
-    float targetSpeedLimit = mBoosting ? BoostSpeedLimit : SpeedLimit;
-    float approachRate = (targetSpeedLimit > mSpeedLimit) ? 40.0f : 20.0f;
-    mSpeedLimit = Maths::Approach(
-        mSpeedLimit,
-        targetSpeedLimit,
-        approachRate,
-        deltaTime);
-
-    if (mGrounded)
+    if (GetGameState()->mHeadless ||
+        !mMesh3D->IsVisible())
     {
-        float speed = glm::length(mVelocity);
-        glm::vec3 velDir = (speed != 0.0f) ? (mVelocity / speed) : glm::vec3(0.0f, 0.0f, 0.0f);
-
-        // Apply drag first
-        float dragAcceleration = mSurfaceAligned ? 10.0f : 70.0f;
-
-        if (mSurfaceAligned)
-        {
-            const float transverseDrag = 50.0f;
-            float transverseAlpha = 1.0f - fabs(glm::dot(velDir, GetForwardVector()));
-            dragAcceleration = glm::mix(dragAcceleration, transverseDrag, transverseAlpha);
-        }
-
-        speed = Maths::Approach(speed, 0.0f, dragAcceleration, deltaTime);
-        glm::vec3 newVel = glm::vec3(velDir.x * speed, (velDir.y < 0.0f) ? mVelocity.y : velDir.y * speed, velDir.z * speed);
-        mVelocity = newVel;
-
-        if (mSurfaceAligned)
-        {
-            const float minAcceleration = -40.0f;
-
-            glm::vec3 thrustDir = GetForwardVector();
-            thrustDir = thrustDir - glm::dot(thrustDir, mSurfaceNormal) * mSurfaceNormal;
-
-            float accelDir = mBoosting ? 1.0f : mCurrentInput.mAccelerate - mCurrentInput.mReverse;
-            float acceleration = accelDir * (mBoosting ? BoostAcceleration : DefaultAcceleration);
-            acceleration = glm::max(acceleration, minAcceleration);
-            mVelocity += (thrustDir * acceleration * deltaTime);
-
-            // Clamp to speed limit
-            float speed = glm::length(mVelocity);
-            if (speed > mSpeedLimit)
-            {
-                speed = Maths::Damp(speed, mSpeedLimit, 0.005f, deltaTime);
-                mVelocity = Maths::SafeNormalize(mVelocity) * speed;
-            }
-        }
+        return false;
     }
-    else
-    {
-        if (mBoosting)
-        {
-            mVelocity += (AerialBoostAcceleration * GetForwardVector() * deltaTime);
-        }
 
-        if (mSpinTime > 0.0f)
-        {
-            mVelocity.y = 0.0f;
-        }
-    }
-
-    // Update gravity
-    float targetGravity = DefaultGravity;
-    glm::vec3 targetGravityDir = glm::vec3(0.0f, -1.0f, 0.0f);
-
-    if (mGrounded && mSurfaceAligned)
+    Camera3D* camera = GetWorld()->GetActiveCamera();
+    if (camera == nullptr)
     {
-        float speed = length(mVelocity);
-        float gravityAlpha = glm::clamp((speed - 5.0f) / 5.0f, 0.0f, 1.0f);
-        targetGravityDir = glm::mix(glm::vec3(0.0f, -1.0f, 0.0f), -mSurfaceNormal, gravityAlpha);
-        targetGravity = glm::mix(WallGravity, DefaultGravity, fabs(mSurfaceNormal.y));
+        return false;
     }
 
-    mGravity = Maths::Approach(mGravity, targetGravity, 100.0f, deltaTime);
-    mGravityDirection = Maths::Damp(mGravityDirection, targetGravityDir, 0.005f, deltaTime);
-    mGravityDirection = Maths::SafeNormalize(mGravityDirection);
-
-    // Don't apply gravity while double jump spinning
-    if (mSpinTime <= 0.0f)
-    {
-        mVelocity += (mGravity * mGravityDirection * deltaTime);
-    }
-}
+    // Conservative view cone check. It's fine to pose a car that ends up culled,
+    // but a visible car that skipped posing would show its wheels snapped to the bind pose.
+    glm::vec3 toCar = mVisualPosition - camera->GetWorldPosition();
+    float dist = glm::length(toCar);
 
-void Car::UpdateJump(float deltaTime)
-{
-    if (mCurrentInput.mJump &&
-        !mPreviousInput.mJump)
+    if (dist < PoseAlwaysRelevantDist)
     {
-        bool jumped = false;
-
-        if (mGrounded && mSurfaceAligned)
-        {
-            mVelocity += mSmoothedSurfaceNormal * JumpSpeed;
-            mGravity = DefaultGravity;
-            ClearGrounded();
-            jumped = true;
-        }
-        else if (mDoubleJump && (mTimeSinceLastGrounding < DoubleJumpTimeLimit))
-        {
-            glm::vec3 jumpDir = { 0.0f, 1.0f, 0.0f };
-            float jumpSpeed = JumpSpeed;
-
-            // Perform a double jump.
-            float absMotionX = fabs(mCurrentInput.mMotionX);
-            float absMotionY = fabs(mCurrentInput.mMotionY);
-
-            if (absMotionX < 0.5f && absMotionY < 0.5f)
-            {
-                // Undirected double jump
-                jumpDir = GetUpVector();
-                mSpinDirX = 0.0f;
-                mSpinDirZ = 0.0f;
-            }
-            else if (absMotionX > absMotionY)
-            {
-                // Right/Left double jump
-                jumpDir = GetForwardVector();
-                jumpDir = glm::rotate(jumpDir, -90.0f * DEGREES_TO_RADIANS, glm::vec3(0.0f, 1.0f, 0.0f));
-
-                mSpinDirX = 0.0f;
-                mSpinDirZ = (mCurrentInput.mMotionX < 0.0f) ? 1.0f : -1.0f;
-                jumpDir *= -mSpinDirZ;
-                mSpinTime = DoubleJumpSpinDuration;
-
-                jumpSpeed = SpinJumpSpeed;
-            }
-            else
-            {
-                // Forward/Backward double jump
-                jumpDir = GetForwardVector();
-                jumpDir.y = 0.0f;
-                jumpDir = Maths::SafeNormalize(jumpDir);
-
-                mSpinDirX = (mCurrentInput.mMotionY < 0.0f) ? 1.0f : -1.0f;
-                mSpinDirZ = 0.0f;
-                jumpDir *= -mSpinDirX;
-                mSpinTime = DoubleJumpSpinDuration;
-
-                jumpSpeed = SpinJumpSpeed;
-            }
-
-            mVelocity += (jumpDir * jumpSpeed);
-            mDoubleJump = false;
-            jumped = true;
-        }
-
-        if (jumped)
-        {
-            if (mJumpAudio3D->IsPlaying())
-            {
-                mJumpAudio3D->ResetAudio();
-                mJumpAudio3D->PlayAudio();
-            }
-
-            mJumpAudio3D->PlayAudio();
-        }
+        return true;
     }
 
-    if (mSpinTime > 0.0f)
-    {
-        mSpinTime -= deltaTime;
-
-        if (mSpinTime <= 0.0f ||
-            (mGrounded && mSurfaceAligned))
-        {
-            // Stop spin
-            mSpinTime = 0.0f;
-        }
-
-        const float RotationSpeed = 360.0f / DoubleJumpSpinDuration;
-
-        glm::vec3 deltaRot = { mSpinDirX, 0.0f, mSpinDirZ };
-        deltaRot *= (RotationSpeed * deltaTime * DEGREES_TO_RADIANS);
-        glm::quat quatRot = glm::quat(deltaRot);
-        SetRotation(GetRotationQuat() * quatRot);
-    }
+    return glm::dot(toCar / dist, camera->GetForwardVector()) > PoseRelevantCos;
 }
 
 void Car::UpdateCamera(float deltaTime)
@@ -1098,24 +1344,27 @@ void Car::UpdateCamera(float deltaTime)
     }
 
     Ball* ball = GetMatchState()->mBall;
-    glm::vec3 focusDirection = mMotionDirection;
+    glm::vec3 focusDirection = mPhysics.mMotionDirection;
 
     if (ball != nullptr)
     {
+        const BallPredictor& predictor = GetMatchState()->mBallPredictor;
+        glm::vec3 ballPos = predictor.IsValid() ? predictor.GetPosition(BallCamLookAhead) : ball->GetPosition();
+
         if (NetIsAuthority())
         {
-            smoothedBallPos = ball->GetPosition();
+            smoothedBallPos = ballPos;
         }
         else
         {
-            smoothedBallPos = Maths::Damp(smoothedBallPos, ball->GetPosition(), 0.0005f, deltaTime);
+            smoothedBallPos = Maths::Damp(smoothedBallPos, ballPos, 0.0005f, deltaTime);
         }
     }
 
     if (mBallCam &&
         ball != nullptr)
     {
-        focusDirection = smoothedBallPos - GetPosition();
+        focusDirection = smoothedBallPos - mVisualPosition;
         focusDirection = Maths::SafeNormalize(focusDirection);
     }
 
@@ -1180,7 +1429,7 @@ void Car::UpdateCamera(float deltaTime)
         mCameraArmPitch = Maths::Approach(mCameraArmPitch, 0.0f, CameraSpeed, deltaTime);
         cameraPos = glm::rotate(cameraPos, DEGREES_TO_RADIANS * mCameraArmPitch, glm::vec3(1.0f, 0.0f, 0.0f));
         cameraPos = glm::rotate(cameraPos, DEGREES_TO_RADIANS * -mCameraYaw, glm::vec3(0.0f, 1.0f, 0.0f));
-        cameraPos = GetPosition() + cameraPos;
+        cameraPos = mVisualPosition + cameraPos;
 
         // Ball cam uses the camera to ball direction for determining pitch.
         glm::vec3 cameraToBall = smoothedBallPos - cameraPos;
@@ -1193,9 +1442,9 @@ void Car::UpdateCamera(float deltaTime)
         // Free cam uses the focus direction as the pitch.
         pitch = asinf(y / 1.0f) * RADIANS_TO_DEGREES;
 
-        if (mGrounded && mSurfaceAligned)
+        if (mPhysics.mGrounded && mPhysics.mSurfaceAligned)
         {
-            glm::vec3 groundedDir = focusDirection - glm::dot(focusDirection, mSurfaceNormal) * mSurfaceNormal;
+            glm::vec3 groundedDir = focusDirection - glm::dot(focusDirection, mPhysics.mSurfaceNormal) * mPhysics.mSurfaceNormal;
             groundedDir = Maths::SafeNormalize(groundedDir);
             pitch = asinf(groundedDir.y / 1.0f) * RADIANS_TO_DEGREES;
         }
@@ -1207,228 +1456,163 @@ void Car::UpdateCamera(float deltaTime)
 
         cameraPos = glm::rotate(cameraPos, DEGREES_TO_RADIANS * (mCameraArmPitch - mCameraPitchOffset), glm::vec3(1.0f, 0.0f, 0.0f));
         cameraPos = glm::rotate(cameraPos, DEGREES_TO_RADIANS * (-mCameraYaw - mCameraYawOffset), glm::vec3(0.0f, 1.0f, 0.0f));
-        cameraPos = GetPosition() + cameraPos;
+        cameraPos = mVisualPosition + cameraPos;
     }
 
-    UpdateTransform(true);
+    // Only the car's own matrix is needed to place the camera, its children are updated before rendering.
+    UpdateTransform(false);
 
     mCamera3D->SetWorldPosition(cameraPos);
     mCamera3D->SetWorldRotation(glm::vec3(mCameraPitch - mCameraPitchOffset, -mCameraYaw - mCameraYawOffset, 0.0f));
 }
 
-void Car::UpdateGrounded(float deltaTime)
+void Car::UpdateAudio(float deltaTime)
 {
-    mTimeSinceLastGrounding += deltaTime;
-
-    if (mTimeSinceLastGrounding > 0.050f)
+    if (GetGameState()->mHeadless)
     {
-        ClearGrounded();
-    }
-    else if (mGrounded)
-    {
-        if (mSurfaceAligned)
-        {
-            mSmoothedSurfaceNormal = Maths::Damp(mSmoothedSurfaceNormal, mSurfaceNormal, 0.005f, deltaTime);
-
-            // Align car with surface normal when grounded.
-            glm::vec3 forward = GetForwardVector();
-            glm::vec3 normal = mSmoothedSurfaceNormal;
-            glm::vec3 newForward = forward - glm::dot(normal, forward) * normal;
-            newForward = glm::normalize(newForward);
-            LookAt(GetPosition() + newForward, normal);
-
-            // Sweep towards surface normal a tiny bit to check if we are still grounded.
-            if (mSurfaceNormal.y > 0.0f)
-            {
-                glm::vec3 truePosition = GetPosition();
-                const float groundingThreshold = 0.3f;
-                SweepTestResult sweepResult;
-                SweepToWorldPosition(truePosition - mSurfaceNormal * groundingThreshold, sweepResult, ColGroupEnvironment);
-
-                if (sweepResult.mHitFraction != 1.0f)
-                {
-                    mTimeSinceLastGrounding = 0.0f;
-                }
-
-                SetPosition(truePosition);
-            }
-        }
-        else
-        {
-            // Magnetise car rotation to surface. (usually try to flip it upright)
-            mSmoothedSurfaceNormal = GetUpVector();
-            glm::vec3 up = GetUpVector();
-            glm::vec3 normal = mSurfaceNormal;
-
-            glm::vec3 newUp = Maths::Damp(up, normal, 0.005f, deltaTime);
-            glm::quat rot = glm::rotation(up, newUp);
-            AddRotation(rot);
-        }
-
-        mMotionDirection = GetForwardVector();
+        return;
     }
-}
 
-void Car::UpdateAudio(float deltaTime)
-{
-    float speed = glm::length(mVelocity);
+    float speed = glm::length(mPhysics.mVelocity);
     float volumeAlpha = glm::clamp(speed / SpeedLimit, 0.1f, 1.0f);
     float pitchAlpha = glm::clamp(speed / SpeedLimit, 0.0f, 1.0f);
     mEngineAudio3D->SetVolume(volumeAlpha * 1.0f);
     mEngineAudio3D->SetPitch(glm::mix(1.0f, 1.3f, pitchAlpha));
 }
 
-void Car::UpdateMotion(float deltaTime)
+void Car::BeginRemoteMotion()
 {
-    float remainingTime = deltaTime;
-    uint8_t collisionMask = GetCollisionMask();
-    glm::vec3 startPos = GetPosition();
-
-    SweepTestResult sweepResult;
-    bool hit = SweepToWorldPosition(GetPosition() + mVelocity * remainingTime, sweepResult, collisionMask);
-
-    if (hit && sweepResult.mHitNode != nullptr &&
-        sweepResult.mHitNode->Is(Ball::ClassRuntimeId()))
-    {
-        HandleCollision(this, sweepResult.mHitNode, sweepResult.mHitPosition, sweepResult.mHitNormal, nullptr);
-
-        // Sweep again, but this time ignoring the ball.
-        remainingTime = remainingTime * (1.0f - sweepResult.mHitFraction);
-        collisionMask = (collisionMask & (~ColGroupBall));
-        hit = SweepToWorldPosition(GetPosition() + mVelocity * remainingTime, sweepResult, collisionMask);
-    }
-
-    if (hit)
-    {
-        HandleCollision(this, sweepResult.mHitNode, sweepResult.mHitPosition, sweepResult.mHitNormal, nullptr);
-
-        remainingTime = remainingTime * (1.0f - sweepResult.mHitFraction);
-        glm::vec3 normal = sweepResult.mHitNormal;
-        glm::vec3 parallelVelocity = mVelocity - (normal * glm::dot(mVelocity, normal));
-        mVelocity = parallelVelocity;
-
-        // Slide along surface
-        hit = SweepToWorldPosition(GetPosition() + mVelocity * remainingTime, sweepResult, collisionMask);
+    mRemotePosition = GetPosition();
+}
 
-        if (hit)
-        {
-            HandleCollision(this, sweepResult.mHitNode, sweepResult.mHitPosition, sweepResult.mHitNormal, nullptr);
-        }
-    }
+void Car::UpdateMotion(float deltaTime)
+{
+    mPhysics.mPosition = GetPosition();
+    mPhysics.mRotation = GetRotationQuat();
+    CarPhysics::UpdateMotion(mPhysics, deltaTime, &mCollisionQuery);
+    SetPosition(mPhysics.mPosition);
+}
 
-    // If this is a client's car and we are updating on the server, then reset to its initial position
-    // because we want to give clients control over their transform. We only do the above sweeps because
-    // we want the server to determine ball hits / bumps / demolitions.
-    if (NetIsAuthority() &&
-        mOwningHost != SERVER_HOST_ID &&
-        mOwningHost != INVALID_HOST_ID)
-    {
-        SetPosition(startPos);
-    }
+void Car::EndRemoteMotion()
+{
+    // Clients have control over their car's transform, so put it back where the client says it is.
+    // The server only moves it above to determine ball hits / bumps / demolitions.
+    SetPosition(mRemotePosition);
 }
 
 void Car::BotUpdateTarget(float deltaTime)
 {
+    OCT_ASSERT(mTeamIndex == 0 || mTeamIndex == 1);
+    const BotBlackboard& blackboard = GetMatchState()->mBotBlackboards[mTeamIndex];
+    const BoostIndex& boostIndex = GetMatchState()->mBoostIndex;
+    const BotDecisionTable& table = GetMatchState()->mBotDecisions.GetTable(mBotBehavior);
+
     Ball* ball = GetMatchState()->mBall;
-    glm::vec3 ballPos = ball->GetPosition();
-    glm::vec3 carPos = GetPosition();
+    glm::vec3 carPos = mBotView.mPosition;
+    glm::vec3 ballPos = GetBallInterceptPosition(carPos, mBotView.mVelocity, mBotBudget.mPredictionHorizon);
     glm::vec3 toBall = ballPos - carPos;
     float distToBall = glm::length(toBall);
     toBall = glm::normalize(toBall);
 
-    glm::vec3 forwardDir = (mTeamIndex == 0) ? glm::vec3(1, 0, 0) : glm::vec3(-1, 0, 0);
-    float ballForwardness = glm::dot(forwardDir, toBall);
-    float ballAlignment = glm::dot(GetForwardVector(), toBall);
+    glm::vec3 forwardDir = blackboard.mForwardDir;
 
     const float forwardingRadius = 45.0f;
     const float approachRadius = 10.0f;
-    const float ballTargetRadius = (mBotBehavior == BotBehavior::Offense) ? 50.0f : 25.0f;
-    const float lowBoostFuel = (mBotBehavior == BotBehavior::Support) ? 40.0f : 5.0f;
-    const float defendBallLimitX = 0.0f;
-    const float ballForwardnessThreshold = 0.0f;
 
     mBotTargetTime += deltaTime;
 
-    bool needsNewTarget = false;
-    float targetDistance = glm::distance(carPos, mBotTargetActor ? mBotTargetActor->GetPosition() : mBotTargetPosition);
-
-    // (1) Determine if we need a new target.
-    // (2) If so, pick a new target.
-
     if (mBotTargetType == BotTargetType::Count)
     {
-        // Invalid target
-        needsNewTarget = true;
+        mBotGoal = BotGoal::Count;
     }
-    else if (mBotTargetType == BotTargetType::Ball &&
-                ballForwardness < ballForwardnessThreshold)
+
+    float targetDistance = (mBotGoal != BotGoal::Count) ? glm::distance(carPos, GetBotTargetActorPosition()) : 0.0f;
+    float travelSpeed = glm::max(glm::length(mBotView.mVelocity), SpeedLimit);
+    bool targetAvailable = (mBotGoal != BotGoal::Boost) || boostIndex.IsAvailableBy(mBotTargetBoost, targetDistance / travelSpeed);
+
+    float factors[uint32_t(BotFactor::Count)];
+    factors[uint32_t(BotFactor::BallDistance)] = distToBall;
+    factors[uint32_t(BotFactor::BallForward)] = glm::dot(forwardDir, toBall);
+    factors[uint32_t(BotFactor::BallAlign)] = glm::dot(mBotView.GetForwardVector(), toBall);
+    factors[uint32_t(BotFactor::BallClaimed)] = blackboard.IsBallClaimedByOther(this, distToBall) ? 1.0f : 0.0f;
+    factors[uint32_t(BotFactor::BallSide)] = ballPos.x * forwardDir.x;
+    factors[uint32_t(BotFactor::UnderThreat)] = blackboard.mUnderThreat ? 1.0f : 0.0f;
+    factors[uint32_t(BotFactor::BoostFuel)] = mBotView.mBoostFuel;
+    factors[uint32_t(BotFactor::BoostFound)] = 1.0f;
+    factors[uint32_t(BotFactor::TargetTime)] = mBotTargetTime;
+    factors[uint32_t(BotFactor::TargetDistance)] = targetDistance;
+    factors[uint32_t(BotFactor::TargetAvailable)] = targetAvailable ? 1.0f : 0.0f;
+
+    int32_t rule = table.Evaluate(factors, mBotGoal);
+    int32_t boost = BOOST_INDEX_NONE;
+
+    // Pad searches aren't free, so assume one is found and only look when picking a pad would win.
+    if (rule != BOT_DECISION_NONE &&
+        !table.IsHold(rule) &&
+        table.mGoals[rule] == BotGoal::Boost)
     {
-        // Car is behind ball. Don't want to hit it wrong way.
-        needsNewTarget = true;
+        boost = FindBestBoost(ballPos);
+
+        if (boost == BOOST_INDEX_NONE)
+        {
+            factors[uint32_t(BotFactor::BoostFound)] = 0.0f;
+            rule = table.Evaluate(factors, mBotGoal);
+        }
     }
-    else if (mBotTargetType == BotTargetType::Boost &&
-                (mBoostFuel >= 40.0f || mBotTargetTime >= 8.0f || targetDistance < 1.0f))
+
+    BotGoal newGoal = BotGoal::Count;
+
+    if (rule != BOT_DECISION_NONE &&
+        !table.IsHold(rule))
     {
-        // Car has enough boost now. Target something else.
-        needsNewTarget = true;
+        newGoal = table.mGoals[rule];
     }
-    else if (mBotTargetType == BotTargetType::Position &&
-                (mBotTargetTime >= 8.0f || targetDistance < 2.0f))
+    else if (rule == BOT_DECISION_NONE &&
+             mBotGoal == BotGoal::Count)
     {
-        // Bot is possibly stuck?
-        needsNewTarget = true;
+        // Nothing in the table applies and there's no target to keep. Fall back to defending.
+        newGoal = BotGoal::OwnGoal;
     }
-    else if (mBotTargetType != BotTargetType::Ball &&
-             ballForwardness >= ballForwardnessThreshold &&
-             distToBall <= ballTargetRadius &&
-             ballAlignment >= 0.0f)
+
+    if (newGoal == BotGoal::Boost &&
+        boost == BOOST_INDEX_NONE)
     {
-        // Prioritize hitting the ball!
-        needsNewTarget = true;
+        newGoal = (mBotGoal == BotGoal::Count) ? BotGoal::OwnGoal : BotGoal::Count;
     }
 
-
-    if (needsNewTarget)
+    if (newGoal != BotGoal::Count)
     {
-        mBotTargetType = BotTargetType::Count;
+        mBotGoal = newGoal;
+        mBotTargetType = BotTargetType::Position;
         mBotTargetActor = nullptr;
+        mBotTargetBoost = BOOST_INDEX_NONE;
         mBotTargetPosition = {};
         mBotTargetTime = 0.0f;
 
-        if (ballForwardness < ballForwardnessThreshold)
-        {
-            // If behind the ball, pick a random point in front of the ball
-            glm::vec3 centerPos = ballPos - forwardDir * forwardingRadius;
-            mBotTargetPosition = FindRandomPointInCircleXZ(centerPos, forwardingRadius);
-            mBotTargetType = BotTargetType::Position;
-        }
-        else if (distToBall <= ballTargetRadius)
+        switch (mBotGoal)
         {
-            // If the ball is within XXm, target the ball.
+        case BotGoal::Ball:
             mBotTargetActor = ball;
             mBotTargetType = BotTargetType::Ball;
-        }
-        else if (mBoostFuel < lowBoostFuel)
-        {
-            // If the ball is farther than XXm and boost < 5, target big boost
-            mBotTargetActor = FindClosestFullBoost();
+            break;
+
+        case BotGoal::Boost:
+            mBotTargetBoost = boost;
+            mBotTargetActor = boostIndex.GetPad(boost).mPickup;
             mBotTargetType = BotTargetType::Boost;
-        }
-        else if (mBotBehavior != BotBehavior::Defense ||
-                (ballPos.x * forwardDir.x < defendBallLimitX))
-        {
-            // If the ball is farther than XXmm and boost >= 5, target random point in front of ball
-            glm::vec3 centerPos = ballPos - forwardDir * approachRadius;
-            mBotTargetPosition = FindRandomPointInCircleXZ(centerPos, approachRadius);
-            mBotTargetType = BotTargetType::Position;
-        }
-        else
-        {
-            // Head to someplace near own goal
-            OCT_ASSERT(mTeamIndex == 0 || mTeamIndex == 1);
-            glm::vec3 centerPos = GetMatchState()->mGoalBoxes[mTeamIndex]->GetPosition() + forwardDir * 20.0f;
-            mBotTargetPosition = FindRandomPointInCircleXZ(centerPos, 10.0f);
-            mBotTargetType = BotTargetType::Position;
+            break;
+
+        case BotGoal::FrontOfBall:
+            mBotTargetPosition = FindRandomPointInCircleXZ(ballPos - forwardDir * forwardingRadius, forwardingRadius);
+            break;
+
+        case BotGoal::NearBall:
+            mBotTargetPosition = FindRandomPointInCircleXZ(ballPos - forwardDir * approachRadius, approachRadius);
+            break;
+
+        default:
+            mBotTargetPosition = FindRandomPointInCircleXZ(blackboard.mOwnGoalPosition + forwardDir * 20.0f, 10.0f);
+            break;
         }
 
         if (mBotTargetType == BotTargetType::Position)
@@ -1447,19 +1631,87 @@ void Car::BotUpdateTarget(float deltaTime)
     //GetWorld()->AddLine(line);
 }
 
-void Car::BotUpdateHandling(float deltaTime)
+void Car::BotUpdatePlan(TaskPool* pool)
+{
+    MatchState* match = GetMatchState();
+    mBotPlanActive = false;
+
+    if (!match->mBotPlanning ||
+        mBotRolloutBudget == 0)
+    {
+        return;
+    }
+
+    BotPlanRequest request;
+    request.mCarState = mBotView;
+    request.mCarRadius = GetRadius();
+    request.mEnemyGoalPosition = match->mBotBlackboards[mTeamIndex].mEnemyGoalPosition;
+    request.mBallPredictor = match->mBallPredictor;
+    request.mArenaSdf = match->mArenaSdf.IsLoaded() ? &match->mArenaSdf : nullptr;
+    request.mNumRollouts = mBotRolloutBudget;
+    request.mSeed = mBotPlanCount++;
+
+    const BotPlan& plan = mBotPlanner.Plan(request, pool);
+
+    // Only follow the plan if it actually gets to the ball, the target logic handles everything else.
+    mBotPlanActive = plan.TouchesBall();
+    mBotPlanTime = 0.0f;
+}
+
+void Car::BotUpdateAerial()
+{
+    if (mBotTargetType != BotTargetType::Ball)
+    {
+        mBotAerialActive = false;
+        return;
+    }
+
+    // An aerial in progress re-aims itself every tick, so there is nothing to re-solve.
+    if (mBotAerialActive)
+    {
+        return;
+    }
+
+    MatchState* match = GetMatchState();
+    const BotBlackboard& blackboard = match->mBotBlackboards[mTeamIndex];
+
+    AerialRequest request;
+    request.mCarState = mBotView;
+    request.mBallPredictor = &match->mBallPredictor;
+    request.mHorizon = mBotBudget.mPredictionHorizon;
+
+    // Aim a little behind the ball so the touch sends it toward the enemy goal.
+    glm::vec3 goalDir = Maths::SafeNormalize(blackboard.mEnemyGoalPosition - blackboard.mBallPosition);
+    request.mTargetOffset = -goalDir * (BALL_RADIUS * 0.5f);
+
+    if (AerialSolver::Solve(request, mBotAerial))
+    {
+        mBotAerialActive = true;
+        mBotAerialTime = 0.0f;
+        mBotPlanActive = false;
+    }
+}
+
+void Car::BotUpdateHandling(float deltaTime, CarInput& outInput)
 {
-    glm::vec3 carPos = GetPosition();
-    glm::vec3 targetPos = (mBotTargetType == BotTargetType::Position) ? mBotTargetPosition : mBotTargetActor->GetPosition();
+    glm::vec3 carPos = mBotView.mPosition;
+    glm::vec3 targetPos = GetBotTargetActorPosition();
+
+    // Drive to where the ball will be, not where it is.
+    glm::vec3 ballPos = {};
+    if (mBotTargetType == BotTargetType::Ball)
+    {
+        ballPos = GetBallInterceptPosition(carPos, mBotView.mVelocity, mBotBudget.mPredictionHorizon);
+        targetPos = ballPos;
+    }
+
     targetPos.y = carPos.y;
 
     // For Ball targeting, bias the target position slightly so that the car will hit it toward the goal.
     if (mBotTargetType == BotTargetType::Ball)
     {
-        int32_t enemyTeam = (mTeamIndex == 0) ? 1 : 0;
-        Node3D* enemyGoalBox = GetMatchState()->mGoalBoxes[enemyTeam];
-        Ball* ball = GetMatchState()->mBall;
-        glm::vec3 goalDir = enemyGoalBox->GetPosition() - ball->GetPosition();
+        const BotBlackboard& blackboard = GetMatchState()->mBotBlackboards[mTeamIndex];
+        glm::vec3 goalDir = blackboard.mEnemyGoalPosition - ballPos;
         goalDir.y = 0.0f;
         goalDir = glm::normalize(goalDir);
         
@@ -1467,7 +1719,14 @@ void Car::BotUpdateHandling(float deltaTime)
         targetPos -= goalDir * biasStrength;
     }
 
-    glm::vec3 forwardXZ = GetForwardVector();
+    // Steer around walls and goal posts rather than straight at the target.
+    glm::vec3 navDir;
+    if (GetMatchState()->mNavGrid.GetSteerDirection(carPos, targetPos, navDir))
+    {
+        targetPos = carPos + navDir * glm::distance(carPos, targetPos);
+    }
+
+    glm::vec3 forwardXZ = mBotView.GetForwardVector();
     forwardXZ.y = 0.0f;
     forwardXZ = glm::normalize(forwardXZ);
 
@@ -1476,19 +1735,19 @@ void Car::BotUpdateHandling(float deltaTime)
     toTarget = glm::normalize(toTarget);
 
     float alignment = glm::dot(toTarget, forwardXZ);
-    float carSpeed = glm::length(mVelocity);
+    float carSpeed = glm::length(mBotView.mVelocity);
 
     if (dist < 5.0f &&
         alignment < -0.8f)
     {
         // If we are close to the target, facing away from it, reverse into it.
-        mCurrentInput.mAccelerate = 0.0f;
-        mCurrentInput.mReverse = 1.0f;
-        mCurrentInput.mMotionX = 0.0f;
-        mCurrentInput.mMotionY = 0.0f;
-        mCurrentInput.mSlide = false;
-        mCurrentInput.mBoost = false;
-        mCurrentInput.mJump = false;
+        outInput.mAccelerate = 0.0f;
+        outInput.mReverse = 1.0f;
+        outInput.mMotionX = 0.0f;
+        outInput.mMotionY = 0.0f;
+        outInput.mSlide = false;
+        outInput.mBoost = false;
+        outInput.mJump = false;
     }
     else
     {
@@ -1499,63 +1758,117 @@ void Car::BotUpdateHandling(float deltaTime)
         float accel = (mBotTargetType == BotTargetType::Ball) ? 1.0f : (dist / 10.0f);
         accel = glm::clamp(accel, 0.0f, 1.0f);
 
-        mCurrentInput.mMotionX = rightSide ? 1.0f : -1.0f;
-        mCurrentInput.mAccelerate = accel;
-        mCurrentInput.mReverse = 0.0f;
-        mCurrentInput.mMotionY = 0.0f;
-        mCurrentInput.mSlide = (alignment < 0.8f) || (carSpeed < 0.5f);
-        mCurrentInput.mBoost = (mBotTargetType == BotTargetType::Ball && alignment >= 0.75f);
-        mCurrentInput.mJump = false;
+        outInput.mMotionX = rightSide ? 1.0f : -1.0f;
+        outInput.mAccelerate = accel;
+        outInput.mReverse = 0.0f;
+        outInput.mMotionY = 0.0f;
+        outInput.mSlide = (alignment < 0.8f) || (carSpeed < 0.5f);
+        outInput.mBoost = (mBotTargetType == BotTargetType::Ball && alignment >= 0.75f);
+        outInput.mJump = false;
     }
 }
 
-void Car::UpdateDebug(float deltaTime)
+glm::vec3 Car::GetBallInterceptPosition() const
+{
+    return GetBallInterceptPosition(GetPosition(), mPhysics.mVelocity, BALL_PREDICTION_TIME);
+}
+
+glm::vec3 Car::GetBallInterceptPosition(glm::vec3 position, glm::vec3 velocity, float horizon) const
 {
+    MatchState* match = GetMatchState();
+    const BallPredictor& predictor = match->mBallPredictor;
+
+    if (!predictor.IsValid())
+    {
+        return match->mBotBlackboards[mTeamIndex].mBallPosition;
+    }
+
+    // Assume the car can at least get up to normal driving speed on the way there.
+    float speed = glm::max(glm::length(velocity), SpeedLimit);
+    float reachTime = predictor.FindReachTime(position, speed, horizon);
+
+    if (reachTime < 0.0f)
+    {
+        reachTime = horizon;
+    }
 
+    return predictor.GetPosition(reachTime);
 }
 
-void Car::ClearGrounded()
+void Car::UpdateDebug(float deltaTime)
 {
-    mGrounded = false;
-    mSurfaceAligned = false;
-    mSurfaceNormal = glm::vec3(0.0f, 1.0f, 0.0f);
-    mSmoothedSurfaceNormal = GetUpVector();
+
 }
 
-Node3D* Car::FindClosestFullBoost()
+int32_t Car::FindBestBoost(glm::vec3 destination) const
 {
-    Node3D* retBoost = nullptr;
+    MatchState* match = GetMatchState();
+    const BotBlackboard& blackboard = match->mBotBlackboards[mTeamIndex];
+
+    // Skip pads a teammate is already heading for, and ones that won't be back in time.
+    BoostQuery query;
+    query.mFrom = mBotView.mPosition;
+    query.mTo = destination;
+    query.mSpeed = glm::max(glm::length(mBotView.mVelocity), SpeedLimit);
+    query.mMaxDetour = BotBoostMaxDetour;
+    query.mFuelNeeded = 100.0f - mBotView.mBoostFuel;
+    query.mClaims = blackboard.mBoostClaims;
+    query.mCar = this;
+
+    return match->mBoostIndex.FindBest(query);
+}
 
+void Car::BotApplyClaims()
+{
     MatchState* match = GetMatchState();
+    BotBlackboard& blackboard = match->mBotBlackboards[mTeamIndex];
+    blackboard.ReleaseClaims(this);
 
-    float closestDistSq = FLT_MAX;
-    glm::vec3 carPos = GetPosition();
+    if (mBotTargetType == BotTargetType::Ball)
+    {
+        blackboard.ClaimBall(this, glm::distance(mBotView.mPosition, blackboard.mBallPosition));
+    }
+    else if (mBotTargetType == BotTargetType::Boost)
+    {
+        blackboard.ClaimBoost(this, mBotTargetBoost);
+    }
+}
 
-    for (uint32_t i = 0; i < NUM_FULL_BOOSTS; ++i)
+glm::vec3 Car::GetBotTargetActorPosition() const
+{
+    if (mBotTargetActor == nullptr)
     {
-        float distSq = glm::distance2(match->mFullBoosts[i]->GetPosition(), carPos);
+        return mBotTargetPosition;
+    }
 
-        if (distSq <= closestDistSq)
-        {
-            closestDistSq = distSq;
-            retBoost = match->mFullBoosts[i];
-        }
+    // The ball keeps moving while bots decide, so read it from this frame's blackboard. Boost pads never move.
+    MatchState* match = GetMatchState();
+    if (mBotTargetActor == match->mBall)
+    {
+        return match->mBotBlackboards[mTeamIndex].mBallPosition;
     }
 
-    return retBoost;
+    return mBotTargetActor->GetPosition();
 }
 
 glm::vec3 Car::FindRandomPointInCircleXZ(glm::vec3 center, float radius)
 {
     center.y = 0.5f;
-    float randAngle = Maths::RandRange(0.0f, 360.0f);
-    float randDist = Maths::RandRange(0.0f, radius);
+    float randAngle = BotRandRange(0.0f, 360.0f);
+    float randDist = BotRandRange(0.0f, radius);
     float xOffset = cosf(randAngle) * randDist;
     float zOffset = sinf(randAngle) * randDist;
 
     return (center + glm::vec3(xOffset, 0.0f, zOffset));
 }
 
+float Car::BotRandRange(float min, float max)
+{
+    mBotRandom = mBotRandom * 1664525u + 1013904223u;
+    float alpha = float(mBotRandom >> 8) / float(1 << 24);
+    return min + (max - min) * alpha;
+}
+
 void Car::MoveToRandomSpawnPoint()
 {
     MatchState* match = GetMatchState();
@@ -1564,31 +1877,48 @@ void Car::MoveToRandomSpawnPoint()
     Node3D* spawnActor = (mTeamIndex == 0) ? match->mSpawnPoints0[spawnIndex] : match->mSpawnPoints1[spawnIndex];
     SetPosition(spawnActor->GetPosition());
     SetRotation(glm::vec3(0.0f, (mTeamIndex == 0) ? -90.0f : 90.0f, 0.0f));
+    ResetInterpolation();
     Reset();
 }
 
 void Car::ResetState()
 {
-    mVelocity = glm::vec3(0.0f);
-    mSlideTurnRate = 0.0f;
-    mSpinTime = 0.0f;
-    mGravityDirection = { 0.0f, -1.0f, 0.0f };
-    mSurfaceNormal = { 0.0f, 1.0f, 0.0f };
-    mGravity = 9.8f;
-    mBoostFuel = StartingBoost;
-    mSmoothedSurfaceNormal = { 0.0f, 1.0f, 0.0f };
+    mPhysics.mVelocity = glm::vec3(0.0f);
+    mPhysics.mSlideTurnRate = 0.0f;
+    mPhysics.mSpinTime = 0.0f;
+    mPhysics.mGravityDirection = { 0.0f, -1.0f, 0.0f };
+    mPhysics.mSurfaceNormal = { 0.0f, 1.0f, 0.0f };
+    mPhysics.mGravity = 9.8f;
+    mPhysics.mBoostFuel = StartingBoost;
+    mPhysics.mSmoothedSurfaceNormal = { 0.0f, 1.0f, 0.0f };
 }
 
 void Car::SetBoosting(bool boosting)
 {
-    if (mBoosting != boosting)
+    if (mPhysics.mBoosting != boosting)
     {
-        mBoosting = boosting;
-        mTrailComponent->EnableEmission(boosting);
+        mPhysics.mBoosting = boosting;
+        UpdateBoostEffects();
+    }
+}
 
-        if (boosting)
-        {
-            mBoostAudio3D->PlayAudio();
-        }
+void Car::UpdateBoostEffects()
+{
+    mTrailComponent->EnableEmission(mPhysics.mBoosting);
+
+    if (mPhysics.mBoosting)
+    {
+        mBoostAudio3D->PlayAudio();
     }
+}
+
+void Car::PlayJumpAudio()
+{
+    if (mJumpAudio3D->IsPlaying())
+    {
+        mJumpAudio3D->ResetAudio();
+        mJumpAudio3D->PlayAudio();
+    }
+
+    mJumpAudio3D->PlayAudio();
 }
\ No newline at end of file
@@ -9,21 +9,38 @@
 #include "Nodes/3D/Audio3d.h"
 
 #include "RocketTypes.h"
-
-struct CarInput
+#include "CarPhysics.h"
+#include "BotPlanner.h"
+#include "BoostIndex.h"
+#include "BotScheduler.h"
+#include "AerialSolver.h"
+#include "BotDecisionTable.h"
+
+class Car;
+class ArenaSdf;
+class TaskPool;
+
+// Routes the car physics kernel's sweeps through the Bullet world via the car node,
+// and against the match's arena SDF for environment collision when one is loaded.
+class CarNodeCollisionQuery : public CarCollisionQuery
 {
-    float mMotionX = 0.0f;
-    float mMotionY = 0.0f;
-    float mCameraX = 0.0f;
-    float mCameraY = 0.0f;
-    float mReverse = 0.0f;
-    float mAccelerate = 0.0f;
-
-    bool mJump = false;
-    bool mBoost = false;
-    bool mBallCam = false;
-    bool mSlide = false;
-    bool mMenu = false;
+public:
+
+    virtual bool Sweep(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, CarSweepResult& outResult) override;
+    virtual uint32_t SweepContacts(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, CarSweepResult* outContacts, uint32_t maxContacts) override;
+    virtual float GetClearance(glm::vec3 position) const override;
+    virtual uint8_t GetCollisionMask() const override;
+    virtual void OnContact(CarPhysicsState& state, const CarSweepResult& result) override;
+    virtual bool GetBallMotion(CarBallMotion& outMotion) override;
+    virtual void OnBallImpact(const CarBallMotion& motion, float impactTime) override;
+
+    Car* mCar = nullptr;
+
+protected:
+
+    bool SweepWorld(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, CarSweepResult& outResult);
+    uint32_t SweepWorldContacts(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, CarSweepResult* outContacts, uint32_t maxContacts);
+    const ArenaSdf* GetArenaSdf(glm::vec3 start, glm::vec3 end, uint8_t collisionMask) const;
 };
 
 class Car : public Sphere3D
@@ -48,6 +65,24 @@ public:
         glm::vec3 impactNormal,
         btPersistentManifold* manifold);
 
+    void HandleCarContact(Car* otherCar, glm::vec3 impactNormal);
+
+    const CarPhysicsState& GetPhysicsState() const;
+    CarPhysicsState& GetPhysicsState();
+    const CarInput& GetCurrentInput() const;
+
+    bool IsSimulatedLocally() const;
+    bool IsSteppedByMatch() const;
+    void UpdateControlInput(float deltaTime);
+    void BeginPhysicsStep(float deltaTime);
+    void EndPhysicsStep(float deltaTime);
+    void ResetInterpolation();
+
+    // Cars controlled by remote clients, moved once per fixed step on the server.
+    void BeginRemoteMotion();
+    void UpdateMotion(float deltaTime);
+    void EndRemoteMotion();
+
     SkeletalMesh3D* GetMesh3D();
     Camera3D* GetCamera3D();
 
@@ -62,8 +97,21 @@ public:
 
     void SetBotBehavior(BotBehavior mode);
     BotBehavior GetBotBehavior() const;
+    BotTargetType GetBotTargetType() const;
+    Node3D* GetBotTargetActor() const;
+    int32_t GetBotTargetBoost() const;
 
     void ForceBotTargetBall();
+    void RequestBotThink();
+    void BeginBotDecision(float deltaTime);
+    void BotDecide(TaskPool* pool);
+    void EndBotDecision();
+    void SetBotRolloutBudget(uint32_t numRollouts);
+    uint32_t GetBotRolloutBudget() const;
+    void SetBotDifficulty(BotDifficulty difficulty);
+    BotDifficulty GetBotDifficulty() const;
+    void SetBotSeed(uint32_t seed);
+    const BotBudget& GetBotBudget() const;
 
     int32_t GetTeamIndex() const;
     void SetTeamIndex(int32_t index);
@@ -78,34 +126,41 @@ public:
     float GetBoostFuel() const;
 
     void Kill();
+    bool IsAlive() const;
     void Respawn();
 
     bool IsLocallyControlled() const;
 
 protected:
 
+    void UpdateVisualTransform();
     void UpdateBotInput(float deltaTime);
     void UpdateInput(float deltaTime);
     void UpdateRespawn(float deltaTime);
-    void UpdateBoost(float deltaTime);
-    void UpdateRotation(float deltaTime);
-    void UpdateVelocity(float deltaTime);
-    void UpdateJump(float deltaTime);
+    void UpdateMeshPose(float deltaTime);
+    bool IsPoseRelevant() const;
+    void UpdateShadowTransform();
     void UpdateCamera(float deltaTime);
-    void UpdateMotion(float deltaTime);
-    void UpdateGrounded(float deltaTime);
     void UpdateAudio(float deltaTime);
     void UpdateDebug(float deltaTime);
 
     void BotUpdateTarget(float deltaTime);
-    void BotUpdateHandling(float deltaTime);
-
-    void ClearGrounded();
-    Node3D* FindClosestFullBoost();
+    void BotUpdateHandling(float deltaTime, CarInput& outInput);
+    void BotUpdatePlan(TaskPool* pool);
+    void BotUpdateAerial();
+    void BotApplyClaims();
+    glm::vec3 GetBotTargetActorPosition() const;
+    glm::vec3 GetBallInterceptPosition() const;
+    glm::vec3 GetBallInterceptPosition(glm::vec3 position, glm::vec3 velocity, float horizon) const;
+
+    int32_t FindBestBoost(glm::vec3 destination) const;
     glm::vec3 FindRandomPointInCircleXZ(glm::vec3 center, float radius);
+    float BotRandRange(float min, float max);
     void MoveToRandomSpawnPoint();
     void ResetState();
     void SetBoosting(bool boosting);
+    void UpdateBoostEffects();
+    void PlayJumpAudio();
 
     // OnRep functions
     static bool OnRep_NetPosition(Datum* datum, uint32_t index, const void* newValue);
@@ -138,15 +193,26 @@ protected:
     CarInput mCurrentInput;
     CarInput mPreviousInput;
 
-    float mBoostFuel = 35.0f;
-    float mGravity = 9.8f;
-    glm::vec3 mGravityDirection = { 0.0f, -1.0f, 0.0f };
-    glm::vec3 mVelocity = {0.0f, 0.0f, 0.0f};
-    glm::vec3 mSurfaceNormal = {0.0f, 1.0f, 0.0f};
-    glm::vec3 mSmoothedSurfaceNormal = {0.0f, 1.0f, 0.0f};
-    float mSpeedLimit = 20.0f;
+    CarPhysicsState mPhysics;
+    CarNodeCollisionQuery mCollisionQuery;
+
+    // Uploaded transform of a remote client's car, restored after the server's motion steps.
+    glm::vec3 mRemotePosition = {};
+
+    // Render interpolation between fixed physics steps
+    glm::vec3 mPrevPhysicsPosition = {};
+    glm::quat mPrevPhysicsRotation = { 1.0f, 0.0f, 0.0f, 0.0f };
+    glm::vec3 mVisualPosition = {};
+    glm::quat mVisualRotation = { 1.0f, 0.0f, 0.0f, 0.0f };
+
+    // Parent transform the shadow was last placed for
+    glm::vec3 mShadowParentPosition = {};
+    glm::quat mShadowParentRotation = { 0.0f, 0.0f, 0.0f, 0.0f };
+    glm::vec3 mShadowVisualPosition = {};
+
+    // Animation time not yet applied to the mesh while it was off-screen.
+    float mSkippedPoseTime = 0.0f;
 
-    glm::vec3 mMotionDirection = { 0.0f, 0.0f, -1.0f };
     float mCameraRotationSpeed = 720.0f;
     float mCameraYaw = 0.0f;
     float mCameraPitch = 0.0f;
@@ -154,26 +220,15 @@ protected:
     float mCameraYawOffset = 0.0f;
     float mCameraPitchOffset = 0.0f;
 
-    float mSpinTime = 0.0f;
-    float mSpinDirX = 0.0f;
-    float mSpinDirZ = 0.0f;
-
     float mTurnRate = 1.0f;
-    float mSlideTurnRate = 0.0f;
-    float mTimeSinceLastGrounding = 1.0f;
     float mRespawnTime = 0.0f;
-    float mWheelRotationX = 0.0f;
-    float mWheelRotationY = 0.0f;
 
     int32_t mCarIndex = -1;
     int32_t mTeamIndex = -1;
 
     bool mControlEnabled = false;
     bool mAlive = false;
-    bool mBoosting = false;
-    bool mGrounded = false;
-    bool mDoubleJump = false;
-    bool mSurfaceAligned = false;
+    bool mStepWasBoosting = false;
     bool mBallCam = false;
     bool mBot = false;
     bool mInitialPosSet = false;
@@ -189,8 +244,41 @@ protected:
 
     // Bot Data
     BotBehavior mBotBehavior = BotBehavior::Count;
+    BotDifficulty mBotDifficulty = BotDifficulty::Count;
+    BotBudget mBotBudget;
     BotTargetType mBotTargetType = BotTargetType::Count;
+    BotGoal mBotGoal = BotGoal::Count;
     Node3D* mBotTargetActor = nullptr;
+    int32_t mBotTargetBoost = BOOST_INDEX_NONE;
     glm::vec3 mBotTargetPosition = { };
     float mBotTargetTime = 0.0f;
+
+    // Set by the match's BotScheduler when this bot may re-evaluate its target.
+    bool mBotThinkRequested = false;
+    float mBotThinkTime = 0.0f;
+
+    // Rollout planner, used instead of the target steering while its best plan reaches the ball.
+    BotPlanner mBotPlanner;
+    uint32_t mBotRolloutBudget = BOT_PLAN_DEFAULT_ROLLOUTS;
+    uint32_t mBotPlanCount = 0;
+    float mBotPlanTime = 0.0f;
+    bool mBotPlanActive = false;
+
+    // Aerial toward a high ball, flown instead of everything else until the intercept time has passed.
+    AerialPlan mBotAerial;
+    float mBotAerialTime = 0.0f;
+    bool mBotAerialActive = false;
+
+    // Bot decisions read mBotView instead of the live car, and write to the back input buffer,
+    // so that they can run on a worker while the car simulates with the front one.
+    CarPhysicsState mBotView;
+    CarInput mBotInputs[2];
+    uint32_t mBotInputFront = 0;
+    float mBotDecisionTime = 0.0f;
+    bool mBotThinking = false;
+
+    // Decisions draw from their own random state instead of the shared Maths::Rand*(),
+    // reseeded from mBotSeed and the sim tick before each one.
+    uint32_t mBotSeed = 0;
+    uint32_t mBotRandom = 0;
 };
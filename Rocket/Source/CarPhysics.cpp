@@ -0,0 +1,557 @@
+#include "CarPhysics.h"
+
+#include "Maths.h"
+
+#include <glm/gtx/rotate_vector.hpp>
+#include <glm/gtx/quaternion.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+const float GroundingThreshold = 0.3f;
+const float SupportRadius = 2.0f;
+const float SupportNormalTolerance = 0.9999f;
+const float MaxSubstepTravel = 0.5f;
+const float NearSubstepTravel = 0.25f;
+const uint32_t MaxMotionSubsteps = 4;
+
+// Built the same way as Node3D::LookAt(), view matrix inverted back to a rotation,
+// so that aligning to the surface rounds exactly like the Car code it came from.
+static glm::quat LookAtRotation(glm::vec3 position, glm::vec3 target, glm::vec3 up)
+{
+    glm::mat4 rotMat = glm::lookAt(position, target, up);
+    rotMat = glm::inverse(rotMat);
+    return glm::quat(rotMat);
+}
+
+CarStepEvents CarPhysics::Step(CarPhysicsState& state, const CarInput& input, float deltaTime, CarCollisionQuery* query)
+{
+    BeginStep(state, input, deltaTime);
+    UpdateBoost(state, input, deltaTime);
+    UpdateVelocity(state, input, deltaTime);
+    return EndStep(state, input, deltaTime, query);
+}
+
+void CarPhysics::BeginStep(CarPhysicsState& state, const CarInput& input, float deltaTime)
+{
+    // Rotation doesn't depend on boost state, so it can run before the (batchable) boost/velocity update.
+    UpdateRotation(state, input, deltaTime);
+}
+
+CarStepEvents CarPhysics::EndStep(CarPhysicsState& state, const CarInput& input, float deltaTime, CarCollisionQuery* query)
+{
+    CarStepEvents events;
+
+    events.mJumped = UpdateJump(state, input, deltaTime);
+    UpdateMotion(state, deltaTime, query);
+    UpdateGrounded(state, deltaTime, query);
+
+    state.mJumpHeld = input.mJump;
+
+    return events;
+}
+
+void CarPhysics::UpdateBoost(CarPhysicsState& state, const CarInput& input, float deltaTime)
+{
+    CarVelocityStep step;
+    step.Load(state, input);
+    IntegrateBoost(step, deltaTime);
+    step.Store(state);
+}
+
+void CarPhysics::UpdateRotation(CarPhysicsState& state, const CarInput& input, float deltaTime)
+{
+    float motionX = input.mMotionX;
+    float motionY = input.mMotionY;
+
+    // Account for deadzone
+    if (fabs(motionX) < 0.2f)
+    {
+        motionX = 0.0f;
+    }
+
+    if (fabs(motionY) < 0.2f)
+    {
+        motionY = 0.0f;
+    }
+
+    bool grounded = state.mGrounded;
+    bool aligned = state.mSurfaceAligned;
+
+    // Update turn rate
+    if (grounded && aligned && input.mSlide)
+    {
+        float slideDir = 0.0f;
+
+        if (motionX > 0.0f)
+            slideDir = -1.0f;
+        else if (motionX < 0.0f)
+            slideDir = 1.0f;
+
+        bool reversing = input.mAccelerate < input.mReverse;
+        if (reversing)
+        {
+            slideDir *= -1.0f;
+        }
+
+        state.mSlideTurnRate = Maths::Approach(state.mSlideTurnRate, SlideTurnRate * slideDir, 2.0f, deltaTime);
+    }
+    else
+    {
+        state.mSlideTurnRate = Maths::Approach(state.mSlideTurnRate, 0.0f, 2.0f, deltaTime);
+    }
+
+    float turnRate = (grounded && aligned) ? GroundedTurnRate : AerialTurnRate;
+
+    bool reversing =
+        grounded &&
+        aligned &&
+        glm::dot(state.mVelocity, state.GetForwardVector()) < 0.0f;
+
+    float rotX = 0.0f;
+    float rotY = 0.0f;
+    float rotZ = 0.0f;
+    if (!grounded)
+    {
+        if (input.mSlide)
+        {
+            rotZ = turnRate * -motionX * deltaTime;
+        }
+
+        rotX = turnRate * -motionY * deltaTime;
+    }
+
+    if (grounded || !input.mSlide)
+    {
+        rotY = turnRate * -motionX * deltaTime;
+
+        if (grounded)
+        {
+            // Shouldn't be able to turn when not moving
+            float speed = glm::length(state.mVelocity);
+            float turnAlpha = glm::clamp(speed / SpeedLimit, 0.0f, 1.0f);
+            turnAlpha = glm::max(glm::pow(turnAlpha, 0.5f) - 0.05f, 0.0f);
+            rotY *= turnAlpha;
+
+            if (speed > 0.1f && reversing)
+                rotY *= -1.0f;
+
+            rotY += state.mSlideTurnRate * deltaTime;
+        }
+    }
+
+    if (!(grounded && aligned) &&
+        state.mSpinTime > 0.0f)
+    {
+        rotX = 0.0f;
+        rotY = 0.0f;
+        rotZ = 0.0f;
+    }
+
+    glm::quat quatRotX = glm::quat({ rotX, 0.0f, 0.0f });
+    glm::quat quatRotY = glm::quat({ 0.0f, rotY, 0.0f });
+    glm::quat quatRotZ = glm::quat({ 0.0f, 0.0f, rotZ});
+    state.mRotation = state.mRotation * quatRotY * quatRotZ * quatRotX;
+
+    float speed = glm::length(state.mVelocity);
+
+    if (grounded && aligned)
+    {
+        // Convert Forward Velocity
+        const float velocityConversionRate = input.mSlide ? 0.4f : 0.9f;
+
+        glm::vec3 retainedVelocity = state.mVelocity * (1.0f - velocityConversionRate);
+
+        state.mVelocity = (speed > 0.0f) ? glm::normalize(state.mVelocity) : state.mVelocity;
+        state.mVelocity = glm::rotate(state.mVelocity, rotY, glm::vec3(0.0f, 1.0f, 0.0f));
+        state.mVelocity *= (speed * velocityConversionRate);
+        state.mVelocity += retainedVelocity;
+    }
+
+    // Adjust front fender / wheel rotation to match input direction.
+    // Only the angles are tracked here, the owner is responsible for posing the mesh.
+    float targetRotY = -30.0f * motionX;
+    state.mWheelRotationY = Maths::Approach(state.mWheelRotationY, targetRotY, 500.0f, deltaTime);
+
+    float wheelSpeed = -800.0f * glm::clamp(speed / 20.0f, 0.0f, 1.0f);
+    wheelSpeed *= glm::dot(state.mVelocity, state.GetForwardVector()) >= 0.0f ? 1.0f : -1.0f;
+    float deltaWheelAngle = wheelSpeed * deltaTime;
+    state.mWheelRotationX += deltaWheelAngle;
+    state.mWheelRotationX = fmod(state.mWheelRotationX, 360.0f);
+}
+
+void CarPhysics::UpdateVelocity(CarPhysicsState& state, const CarInput& input, float deltaTime)
+{
+    CarVelocityStep step;
+    step.Load(state, input);
+    IntegrateVelocity(step, deltaTime);
+    step.Store(state);
+}
+
+bool CarPhysics::UpdateJump(CarPhysicsState& state, const CarInput& input, float deltaTime)
+{
+    bool jumped = false;
+
+    if (input.mJump &&
+        !state.mJumpHeld)
+    {
+        if (state.mGrounded && state.mSurfaceAligned)
+        {
+            state.mVelocity += state.mSmoothedSurfaceNormal * JumpSpeed;
+            state.mGravity = DefaultGravity;
+            ClearGrounded(state);
+            jumped = true;
+        }
+        else if (state.mDoubleJump && (state.mTimeSinceLastGrounding < DoubleJumpTimeLimit))
+        {
+            glm::vec3 jumpDir = { 0.0f, 1.0f, 0.0f };
+            float jumpSpeed = JumpSpeed;
+
+            // Perform a double jump.
+            float absMotionX = fabs(input.mMotionX);
+            float absMotionY = fabs(input.mMotionY);
+
+            if (absMotionX < 0.5f && absMotionY < 0.5f)
+            {
+                // Undirected double jump
+                jumpDir = state.GetUpVector();
+                state.mSpinDirX = 0.0f;
+                state.mSpinDirZ = 0.0f;
+            }
+            else if (absMotionX > absMotionY)
+            {
+                // Right/Left double jump
+                jumpDir = state.GetForwardVector();
+                jumpDir = glm::rotate(jumpDir, -90.0f * DEGREES_TO_RADIANS, glm::vec3(0.0f, 1.0f, 0.0f));
+
+                state.mSpinDirX = 0.0f;
+                state.mSpinDirZ = (input.mMotionX < 0.0f) ? 1.0f : -1.0f;
+                jumpDir *= -state.mSpinDirZ;
+                state.mSpinTime = DoubleJumpSpinDuration;
+
+                jumpSpeed = SpinJumpSpeed;
+            }
+            else
+            {
+                // Forward/Backward double jump
+                jumpDir = state.GetForwardVector();
+                jumpDir.y = 0.0f;
+                jumpDir = Maths::SafeNormalize(jumpDir);
+
+                state.mSpinDirX = (input.mMotionY < 0.0f) ? 1.0f : -1.0f;
+                state.mSpinDirZ = 0.0f;
+                jumpDir *= -state.mSpinDirX;
+                state.mSpinTime = DoubleJumpSpinDuration;
+
+                jumpSpeed = SpinJumpSpeed;
+            }
+
+            state.mVelocity += (jumpDir * jumpSpeed);
+            state.mDoubleJump = false;
+            jumped = true;
+        }
+    }
+
+    if (state.mSpinTime > 0.0f)
+    {
+        state.mSpinTime -= deltaTime;
+
+        if (state.mSpinTime <= 0.0f ||
+            (state.mGrounded && state.mSurfaceAligned))
+        {
+            // Stop spin
+            state.mSpinTime = 0.0f;
+        }
+
+        const float RotationSpeed = 360.0f / DoubleJumpSpinDuration;
+
+        glm::vec3 deltaRot = { state.mSpinDirX, 0.0f, state.mSpinDirZ };
+        deltaRot *= (RotationSpeed * deltaTime * DEGREES_TO_RADIANS);
+        glm::quat quatRot = glm::quat(deltaRot);
+        state.mRotation = state.mRotation * quatRot;
+    }
+
+    return jumped;
+}
+
+void CarPhysics::UpdateMotion(CarPhysicsState& state, float deltaTime, CarCollisionQuery* query)
+{
+    uint32_t numSubsteps = GetMotionSubsteps(state, deltaTime, query);
+    float substepTime = deltaTime / numSubsteps;
+    uint8_t collisionMask = query->GetCollisionMask();
+
+    // When the ball's motion is known, touches are solved exactly against it rather than found by sweeping.
+    CarBallMotion ballMotion;
+    bool solveBall = (collisionMask & ColGroupBall) && query->GetBallMotion(ballMotion);
+
+    for (uint32_t i = 0; i < numSubsteps; ++i)
+    {
+        UpdateMotionSubstep(state, substepTime, substepTime * i, query, collisionMask, solveBall ? &ballMotion : nullptr);
+    }
+}
+
+uint32_t CarPhysics::GetMotionSubsteps(const CarPhysicsState& state, float deltaTime, CarCollisionQuery* query)
+{
+    float travel = glm::length(state.mVelocity) * deltaTime;
+
+    // Only pay for the clearance query once the car is moving far enough for it to matter.
+    if (travel <= NearSubstepTravel)
+    {
+        return 1;
+    }
+
+    float maxTravel = (query->GetClearance(state.mPosition) < travel) ? NearSubstepTravel : MaxSubstepTravel;
+    uint32_t numSubsteps = uint32_t(ceilf(travel / maxTravel));
+
+    return glm::clamp<uint32_t>(numSubsteps, 1, MaxMotionSubsteps);
+}
+
+void CarPhysics::UpdateMotionSubstep(CarPhysicsState& state, float deltaTime, float stepTime, CarCollisionQuery* query, uint8_t& collisionMask, const CarBallMotion* ballMotion)
+{
+    glm::vec3 startPos = state.mPosition;
+    glm::vec3 endPos = startPos + state.mVelocity * deltaTime;
+    uint8_t sweepMask = collisionMask;
+    float ballTime = -1.0f;
+
+    if (ballMotion != nullptr)
+    {
+        sweepMask = (sweepMask & (~ColGroupBall));
+
+        if (collisionMask & ColGroupBall)
+        {
+            glm::vec3 ballStart = ballMotion->mPosition + ballMotion->mVelocity * stepTime;
+            ballTime = SolveBallImpactTime(startPos, state.mVelocity, ballStart, ballMotion->mVelocity, ballMotion->mContactDistance, deltaTime);
+        }
+    }
+
+    // Gather everything along the path at once. The ball doesn't stop the car,
+    // so a ball touch is resolved and then we carry on to the first blocking contact.
+    CarSweepResult contacts[CAR_MAX_SWEEP_CONTACTS];
+    uint32_t numContacts = query->SweepContacts(startPos, endPos, sweepMask, contacts, CAR_MAX_SWEEP_CONTACTS);
+    uint32_t blockingIndex = 0;
+
+    if (ballTime >= 0.0f &&
+        (numContacts == 0 || ballTime <= contacts[0].mHitFraction * deltaTime))
+    {
+        // Touch at the exact moment the spheres meet. The car's velocity isn't changed by the touch,
+        // so the rest of the substep carries on along the same path.
+        glm::vec3 ballPos = ballMotion->mPosition + ballMotion->mVelocity * (stepTime + ballTime);
+
+        CarSweepResult ballHit;
+        ballHit.mPosition = startPos + state.mVelocity * ballTime;
+        ballHit.mHitNormal = Maths::SafeNormalize(ballHit.mPosition - ballPos);
+        ballHit.mHitPosition = ballPos + ballHit.mHitNormal * ballMotion->mRadius;
+        ballHit.mHitFraction = ballTime / deltaTime;
+        ballHit.mContactType = CarContactType::Ball;
+        ballHit.mHitNode = ballMotion->mNode;
+
+        state.mPosition = ballHit.mPosition;
+        HandleContact(state, ballHit, query);
+        query->OnBallImpact(*ballMotion, stepTime + ballTime);
+
+        collisionMask = (collisionMask & (~ColGroupBall));
+    }
+    else if (numContacts > 0 &&
+        contacts[0].mContactType == CarContactType::Ball)
+    {
+        state.mPosition = contacts[0].mPosition;
+        HandleContact(state, contacts[0], query);
+
+        // Touch the ball at most once per step, even if the remaining substeps run into it again.
+        collisionMask = (collisionMask & (~ColGroupBall));
+        blockingIndex = 1;
+
+        // The ball could be in the list more than once if it has multiple shapes.
+        while (blockingIndex < numContacts &&
+            contacts[blockingIndex].mContactType == CarContactType::Ball)
+        {
+            ++blockingIndex;
+        }
+    }
+
+    if (blockingIndex < numContacts)
+    {
+        const CarSweepResult& blockingHit = contacts[blockingIndex];
+        state.mPosition = blockingHit.mPosition;
+        HandleContact(state, blockingHit, query);
+
+        float remainingTime = deltaTime * (1.0f - blockingHit.mHitFraction);
+        glm::vec3 normal = blockingHit.mHitNormal;
+        glm::vec3 parallelVelocity = state.mVelocity - (normal * glm::dot(state.mVelocity, normal));
+        state.mVelocity = parallelVelocity;
+
+        // Slide along surface
+        CarSweepResult sweepResult;
+        bool hit = query->Sweep(state.mPosition, state.mPosition + state.mVelocity * remainingTime, collisionMask, sweepResult);
+        state.mPosition = sweepResult.mPosition;
+
+        if (hit)
+        {
+            HandleContact(state, sweepResult, query);
+        }
+    }
+    else
+    {
+        state.mPosition = endPos;
+    }
+}
+
+float CarPhysics::SolveBallImpactTime(glm::vec3 carPosition, glm::vec3 carVelocity, glm::vec3 ballPosition, glm::vec3 ballVelocity, float contactDistance, float deltaTime)
+{
+    // Solve |offset + relVelocity * t| = contactDistance for the first t in [0, deltaTime].
+    glm::vec3 offset = ballPosition - carPosition;
+    glm::vec3 relVelocity = ballVelocity - carVelocity;
+    float b = glm::dot(offset, relVelocity);
+    float c = glm::dot(offset, offset) - contactDistance * contactDistance;
+
+    // Moving apart
+    if (b >= 0.0f)
+    {
+        return -1.0f;
+    }
+
+    // Already touching and still closing
+    if (c <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    float a = glm::dot(relVelocity, relVelocity);
+    float discriminant = b * b - a * c;
+
+    if (discriminant < 0.0f)
+    {
+        return -1.0f;
+    }
+
+    float t = (-b - sqrtf(discriminant)) / a;
+    return (t <= deltaTime) ? t : -1.0f;
+}
+
+void CarPhysics::UpdateGrounded(CarPhysicsState& state, float deltaTime, CarCollisionQuery* query)
+{
+    state.mTimeSinceLastGrounding += deltaTime;
+
+    if (state.mTimeSinceLastGrounding > 0.050f)
+    {
+        ClearGrounded(state);
+    }
+    else if (state.mGrounded)
+    {
+        if (state.mSurfaceAligned)
+        {
+            state.mSmoothedSurfaceNormal = Maths::Damp(state.mSmoothedSurfaceNormal, state.mSurfaceNormal, 0.005f, deltaTime);
+
+            // Align car with surface normal when grounded.
+            glm::vec3 forward = state.GetForwardVector();
+            glm::vec3 normal = state.mSmoothedSurfaceNormal;
+            glm::vec3 newForward = forward - glm::dot(normal, forward) * normal;
+            newForward = glm::normalize(newForward);
+            state.mRotation = LookAtRotation(state.mPosition, state.mPosition + newForward, normal);
+
+            // Sweep towards surface normal a tiny bit to check if we are still grounded.
+            // The car stays where it is, we only care whether the probe hits.
+            if (state.mSurfaceNormal.y > 0.0f)
+            {
+                if (IsOnCachedSupport(state))
+                {
+                    state.mTimeSinceLastGrounding = 0.0f;
+                }
+                else
+                {
+                    CarSweepResult sweepResult;
+                    query->Sweep(state.mPosition, state.mPosition - state.mSurfaceNormal * GroundingThreshold, ColGroupEnvironment, sweepResult);
+
+                    state.mSupportCached = false;
+
+                    if (sweepResult.mHitFraction != 1.0f)
+                    {
+                        state.mTimeSinceLastGrounding = 0.0f;
+
+                        // Only cache supports that agree with the surface we are aligned to.
+                        // Creases and curved ramps will keep probing every tick.
+                        if (glm::dot(sweepResult.mHitNormal, state.mSurfaceNormal) > SupportNormalTolerance)
+                        {
+                            state.mSupportCached = true;
+                            state.mSupportPoint = sweepResult.mHitPosition;
+                            state.mSupportNormal = state.mSurfaceNormal;
+                            state.mSupportOrigin = state.mPosition;
+                            state.mSupportHeight = glm::dot(state.mPosition - sweepResult.mHitPosition, state.mSurfaceNormal);
+                        }
+                    }
+                }
+            }
+        }
+        else
+        {
+            // Magnetise car rotation to surface. (usually try to flip it upright)
+            state.mSmoothedSurfaceNormal = state.GetUpVector();
+            glm::vec3 up = state.GetUpVector();
+            glm::vec3 normal = state.mSurfaceNormal;
+
+            glm::vec3 newUp = Maths::Damp(up, normal, 0.005f, deltaTime);
+            glm::quat rot = glm::rotation(up, newUp);
+            state.mRotation = rot * state.mRotation;
+        }
+
+        state.mMotionDirection = state.GetForwardVector();
+    }
+}
+
+void CarPhysics::HandleContact(CarPhysicsState& state, const CarSweepResult& result, CarCollisionQuery* query)
+{
+    glm::vec3 impactNormal = result.mHitNormal;
+    float landingDot = glm::dot(state.GetUpVector(), impactNormal);
+
+    if (impactNormal.y > -0.5f &&
+        landingDot > 0.5f)
+    {
+        state.mGrounded = true;
+        state.mDoubleJump = true;
+        state.mSurfaceAligned = true;
+        state.mTimeSinceLastGrounding = 0.0f;
+        state.mSurfaceNormal = impactNormal;
+    }
+    else if (impactNormal.y > 0.5f)
+    {
+        // In the case that we aren't aligned but we hit something that is mostly a floor,
+        // we still want to update the surface normal and begin to flip the car upright.
+        state.mSurfaceNormal = impactNormal;
+        state.mGrounded = true;
+        state.mDoubleJump = true;
+        state.mSurfaceAligned = false;
+        state.mTimeSinceLastGrounding = 0.0f;
+    }
+
+    query->OnContact(state, result);
+}
+
+void CarPhysics::ClearGrounded(CarPhysicsState& state)
+{
+    state.mSupportCached = false;
+    state.mGrounded = false;
+    state.mSurfaceAligned = false;
+    state.mSurfaceNormal = glm::vec3(0.0f, 1.0f, 0.0f);
+    state.mSmoothedSurfaceNormal = state.GetUpVector();
+}
+
+bool CarPhysics::IsOnCachedSupport(const CarPhysicsState& state)
+{
+    if (!state.mSupportCached ||
+        glm::dot(state.mSurfaceNormal, state.mSupportNormal) < SupportNormalTolerance)
+    {
+        return false;
+    }
+
+    // The probe only tells us about the surface right under the car when it was issued,
+    // so trust it within a small patch and re-probe once we drive off of it.
+    glm::vec3 offset = state.mPosition - state.mSupportOrigin;
+    glm::vec3 lateralOffset = offset - state.mSupportNormal * glm::dot(offset, state.mSupportNormal);
+    if (glm::dot(lateralOffset, lateralOffset) > SupportRadius * SupportRadius)
+    {
+        return false;
+    }
+
+    // Still close enough to the plane that the probe would have hit it.
+    float height = glm::dot(state.mPosition - state.mSupportPoint, state.mSupportNormal);
+    return (height < state.mSupportHeight + GroundingThreshold * 0.5f) &&
+        (height > state.mSupportHeight - GroundingThreshold);
+}
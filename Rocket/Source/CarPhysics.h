@@ -0,0 +1,332 @@
+#pragma once
+
+#include "RocketTypes.h"
+#include "Maths.h"
+
+#include <stdint.h>
+#include <float.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+class Node;
+
+const float SpeedLimit = 20.0f;
+const float BoostSpeedLimit = 40.0f;
+const float BoostDepletionSpeed = 50.0f;
+const float StartingBoost = 35.0f;
+const float DefaultGravity = 9.8f;
+const float WallGravity = 8 * 9.8f;
+const float JumpSpeed = 8.0f;
+const float SpinJumpSpeed = JumpSpeed * 2.0f;
+const float DefaultAcceleration = 30.0f;
+const float BoostAcceleration = DefaultAcceleration;
+const float AerialBoostAcceleration = DefaultAcceleration * 0.8f;
+const float DoubleJumpTimeLimit = 2.0f;
+const float DoubleJumpSpinDuration = 0.8f;
+const float GroundedTurnRate = 2.0f;
+const float SlideTurnRate = 3.0f * GroundedTurnRate;
+const float AerialTurnRate = GroundedTurnRate;
+
+#define CAR_MAX_SWEEP_CONTACTS 8
+
+struct CarInput
+{
+    float mMotionX = 0.0f;
+    float mMotionY = 0.0f;
+    float mCameraX = 0.0f;
+    float mCameraY = 0.0f;
+    float mReverse = 0.0f;
+    float mAccelerate = 0.0f;
+
+    bool mJump = false;
+    bool mBoost = false;
+    bool mBallCam = false;
+    bool mSlide = false;
+    bool mMenu = false;
+};
+
+enum class CarContactType
+{
+    Environment,
+    Ball,
+    Car,
+
+    Count
+};
+
+struct CarSweepResult
+{
+    // Where the car sphere came to rest after the sweep.
+    glm::vec3 mPosition = {};
+    glm::vec3 mHitPosition = {};
+    glm::vec3 mHitNormal = {};
+    float mHitFraction = 1.0f;
+    CarContactType mContactType = CarContactType::Count;
+    Node* mHitNode = nullptr;
+};
+
+// The ball's motion over a step, for solving exact touch times instead of sweeping against it.
+struct CarBallMotion
+{
+    // Where the ball is at the start of the step, adjusted for touches by cars that stepped earlier
+    // so that mPosition + mVelocity * t follows the ball after them.
+    glm::vec3 mPosition = {};
+    glm::vec3 mVelocity = {};
+    float mRadius = 0.0f;
+
+    // Car center to ball center distance at the moment of touch.
+    float mContactDistance = 0.0f;
+    Node* mNode = nullptr;
+};
+
+// Everything needed to step a car's movement. Contains no node/scene pointers
+// so it can be copied around freely by bots, servers and offline tools.
+struct CarPhysicsState
+{
+    glm::vec3 mPosition = { 0.0f, 0.0f, 0.0f };
+    glm::quat mRotation = { 1.0f, 0.0f, 0.0f, 0.0f };
+    glm::vec3 mVelocity = { 0.0f, 0.0f, 0.0f };
+    glm::vec3 mGravityDirection = { 0.0f, -1.0f, 0.0f };
+    glm::vec3 mSurfaceNormal = { 0.0f, 1.0f, 0.0f };
+    glm::vec3 mSmoothedSurfaceNormal = { 0.0f, 1.0f, 0.0f };
+    glm::vec3 mMotionDirection = { 0.0f, 0.0f, -1.0f };
+
+    // Grounding cache. The support plane found by the last grounding probe, and where the car was when it was found.
+    glm::vec3 mSupportPoint = { 0.0f, 0.0f, 0.0f };
+    glm::vec3 mSupportNormal = { 0.0f, 1.0f, 0.0f };
+    glm::vec3 mSupportOrigin = { 0.0f, 0.0f, 0.0f };
+    float mSupportHeight = 0.0f;
+
+    float mBoostFuel = StartingBoost;
+    float mGravity = DefaultGravity;
+    float mSpeedLimit = SpeedLimit;
+    float mSlideTurnRate = 0.0f;
+    float mTimeSinceLastGrounding = 1.0f;
+    float mSpinTime = 0.0f;
+    float mSpinDirX = 0.0f;
+    float mSpinDirZ = 0.0f;
+    float mWheelRotationX = 0.0f;
+    float mWheelRotationY = 0.0f;
+
+    bool mBoosting = false;
+    bool mGrounded = false;
+    bool mDoubleJump = false;
+    bool mSurfaceAligned = false;
+    bool mJumpHeld = false;
+    bool mSupportCached = false;
+
+    glm::vec3 GetForwardVector() const { return mRotation * glm::vec3(0.0f, 0.0f, -1.0f); }
+    glm::vec3 GetUpVector() const { return mRotation * glm::vec3(0.0f, 1.0f, 0.0f); }
+};
+
+// What the boost/velocity update reads and writes. CarPhysics::UpdateBoost()/UpdateVelocity() and
+// CarPhysicsBatch both load a car into this and run the same IntegrateBoost()/IntegrateVelocity() on it.
+struct CarVelocityStep
+{
+    glm::vec3 mVelocity = { 0.0f, 0.0f, 0.0f };
+    glm::vec3 mGravityDirection = { 0.0f, -1.0f, 0.0f };
+    float mGravity = DefaultGravity;
+    float mSpeedLimit = SpeedLimit;
+    float mBoostFuel = 0.0f;
+    bool mBoosting = false;
+
+    // Read only
+    glm::vec3 mForward = { 0.0f, 0.0f, -1.0f };
+    glm::vec3 mSurfaceNormal = { 0.0f, 1.0f, 0.0f };
+    float mSpinTime = 0.0f;
+    float mAccelInput = 0.0f;
+    bool mBoostInput = false;
+    bool mGrounded = false;
+    bool mSurfaceAligned = false;
+
+    void Load(const CarPhysicsState& state, const CarInput& input)
+    {
+        mVelocity = state.mVelocity;
+        mGravityDirection = state.mGravityDirection;
+        mGravity = state.mGravity;
+        mSpeedLimit = state.mSpeedLimit;
+        mBoostFuel = state.mBoostFuel;
+        mBoosting = state.mBoosting;
+        mForward = state.GetForwardVector();
+        mSurfaceNormal = state.mSurfaceNormal;
+        mSpinTime = state.mSpinTime;
+        mAccelInput = input.mAccelerate - input.mReverse;
+        mBoostInput = input.mBoost;
+        mGrounded = state.mGrounded;
+        mSurfaceAligned = state.mSurfaceAligned;
+    }
+
+    void Store(CarPhysicsState& state) const
+    {
+        state.mVelocity = mVelocity;
+        state.mGravityDirection = mGravityDirection;
+        state.mGravity = mGravity;
+        state.mSpeedLimit = mSpeedLimit;
+        state.mBoostFuel = mBoostFuel;
+        state.mBoosting = mBoosting;
+    }
+};
+
+struct CarStepEvents
+{
+    bool mJumped = false;
+};
+
+// Supplies collision to the car kernel. The game implements this on top of the
+// Bullet world, headless tools can implement it against whatever they like.
+class CarCollisionQuery
+{
+public:
+
+    virtual ~CarCollisionQuery() {}
+
+    // Sweep the car sphere from start to end. Returns true if something was hit.
+    virtual bool Sweep(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, CarSweepResult& outResult) = 0;
+
+    // Sweep the car sphere from start to end in a single traversal, gathering the first contact with
+    // every object along the path (not just the closest). Contacts are sorted by hit fraction.
+    virtual uint32_t SweepContacts(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, CarSweepResult* outContacts, uint32_t maxContacts) = 0;
+
+    // Rough distance from the car sphere to the nearest environment surface, used to decide on substepping.
+    // Return FLT_MAX if unknown.
+    virtual float GetClearance(glm::vec3 position) const { return FLT_MAX; }
+
+    // Motion of the ball for this step. Return false to have ball touches found by the sweep instead.
+    virtual bool GetBallMotion(CarBallMotion& outMotion) { return false; }
+
+    // Called after OnContact() for a touch found from GetBallMotion(), impactTime seconds into the step.
+    virtual void OnBallImpact(const CarBallMotion& motion, float impactTime) {}
+
+    // Collision groups the car moves against.
+    virtual uint8_t GetCollisionMask() const = 0;
+
+    // Called after the kernel has applied grounding for a contact.
+    // Handlers may modify the state (e.g. car bumps change velocity).
+    virtual void OnContact(CarPhysicsState& state, const CarSweepResult& result) {}
+};
+
+namespace CarPhysics
+{
+    CarStepEvents Step(CarPhysicsState& state, const CarInput& input, float deltaTime, CarCollisionQuery* query);
+
+    // Step() split around the boost/velocity update so that CarPhysicsBatch can integrate many cars at once.
+    void BeginStep(CarPhysicsState& state, const CarInput& input, float deltaTime);
+    CarStepEvents EndStep(CarPhysicsState& state, const CarInput& input, float deltaTime, CarCollisionQuery* query);
+
+    void UpdateBoost(CarPhysicsState& state, const CarInput& input, float deltaTime);
+    void UpdateRotation(CarPhysicsState& state, const CarInput& input, float deltaTime);
+    void UpdateVelocity(CarPhysicsState& state, const CarInput& input, float deltaTime);
+    bool UpdateJump(CarPhysicsState& state, const CarInput& input, float deltaTime);
+    void UpdateMotion(CarPhysicsState& state, float deltaTime, CarCollisionQuery* query);
+    uint32_t GetMotionSubsteps(const CarPhysicsState& state, float deltaTime, CarCollisionQuery* query);
+    void UpdateMotionSubstep(CarPhysicsState& state, float deltaTime, float stepTime, CarCollisionQuery* query, uint8_t& collisionMask, const CarBallMotion* ballMotion);
+    float SolveBallImpactTime(glm::vec3 carPosition, glm::vec3 carVelocity, glm::vec3 ballPosition, glm::vec3 ballVelocity, float contactDistance, float deltaTime);
+    void UpdateGrounded(CarPhysicsState& state, float deltaTime, CarCollisionQuery* query);
+
+    void HandleContact(CarPhysicsState& state, const CarSweepResult& result, CarCollisionQuery* query);
+    void ClearGrounded(CarPhysicsState& state);
+    bool IsOnCachedSupport(const CarPhysicsState& state);
+
+    inline void IntegrateBoost(CarVelocityStep& step, float deltaTime)
+    {
+        if (step.mBoostInput &&
+            step.mBoostFuel > 0.0f)
+        {
+            step.mBoosting = true;
+
+            step.mBoostFuel -= deltaTime * BoostDepletionSpeed;
+            step.mBoostFuel = glm::max(step.mBoostFuel, 0.0f);
+        }
+        else
+        {
+            step.mBoosting = false;
+        }
+    }
+
+    inline void IntegrateVelocity(CarVelocityStep& step, float deltaTime)
+    {
+        // Update the speed limit. Increases when boost is held.
+        float targetSpeedLimit = step.mBoosting ? BoostSpeedLimit : SpeedLimit;
+        float approachRate = (targetSpeedLimit > step.mSpeedLimit) ? 40.0f : 20.0f;
+        step.mSpeedLimit = Maths::Approach(
+            step.mSpeedLimit,
+            targetSpeedLimit,
+            approachRate,
+            deltaTime);
+
+        if (step.mGrounded)
+        {
+            float speed = glm::length(step.mVelocity);
+            glm::vec3 velDir = (speed != 0.0f) ? (step.mVelocity / speed) : glm::vec3(0.0f, 0.0f, 0.0f);
+
+            // Apply drag first
+            float dragAcceleration = step.mSurfaceAligned ? 10.0f : 70.0f;
+
+            if (step.mSurfaceAligned)
+            {
+                const float transverseDrag = 50.0f;
+                float transverseAlpha = 1.0f - fabs(glm::dot(velDir, step.mForward));
+                dragAcceleration = glm::mix(dragAcceleration, transverseDrag, transverseAlpha);
+            }
+
+            speed = Maths::Approach(speed, 0.0f, dragAcceleration, deltaTime);
+            glm::vec3 newVel = glm::vec3(velDir.x * speed, (velDir.y < 0.0f) ? step.mVelocity.y : velDir.y * speed, velDir.z * speed);
+            step.mVelocity = newVel;
+
+            if (step.mSurfaceAligned)
+            {
+                const float minAcceleration = -40.0f;
+
+                glm::vec3 thrustDir = step.mForward;
+                thrustDir = thrustDir - glm::dot(thrustDir, step.mSurfaceNormal) * step.mSurfaceNormal;
+
+                float accelDir = step.mBoosting ? 1.0f : step.mAccelInput;
+                float acceleration = accelDir * (step.mBoosting ? BoostAcceleration : DefaultAcceleration);
+                acceleration = glm::max(acceleration, minAcceleration);
+                step.mVelocity += (thrustDir * acceleration * deltaTime);
+
+                // Clamp to speed limit
+                float speed = glm::length(step.mVelocity);
+                if (speed > step.mSpeedLimit)
+                {
+                    speed = Maths::Damp(speed, step.mSpeedLimit, 0.005f, deltaTime);
+                    step.mVelocity = Maths::SafeNormalize(step.mVelocity) * speed;
+                }
+            }
+        }
+        else
+        {
+            if (step.mBoosting)
+            {
+                step.mVelocity += (AerialBoostAcceleration * step.mForward * deltaTime);
+            }
+
+            if (step.mSpinTime > 0.0f)
+            {
+                step.mVelocity.y = 0.0f;
+            }
+        }
+
+        // Update gravity
+        float targetGravity = DefaultGravity;
+        glm::vec3 targetGravityDir = glm::vec3(0.0f, -1.0f, 0.0f);
+
+        if (step.mGrounded && step.mSurfaceAligned)
+        {
+            float speed = glm::length(step.mVelocity);
+            float gravityAlpha = glm::clamp((speed - 5.0f) / 5.0f, 0.0f, 1.0f);
+            targetGravityDir = glm::mix(glm::vec3(0.0f, -1.0f, 0.0f), -step.mSurfaceNormal, gravityAlpha);
+            targetGravity = glm::mix(WallGravity, DefaultGravity, fabs(step.mSurfaceNormal.y));
+        }
+
+        step.mGravity = Maths::Approach(step.mGravity, targetGravity, 100.0f, deltaTime);
+        step.mGravityDirection = Maths::Damp(step.mGravityDirection, targetGravityDir, 0.005f, deltaTime);
+        step.mGravityDirection = Maths::SafeNormalize(step.mGravityDirection);
+
+        // Don't apply gravity while double jump spinning
+        if (step.mSpinTime <= 0.0f)
+        {
+            step.mVelocity += (step.mGravity * step.mGravityDirection * deltaTime);
+        }
+    }
+}
@@ -0,0 +1,32 @@
+#include "CarPhysicsBatch.h"
+
+void CarPhysicsBatch::Clear()
+{
+    mCount = 0;
+}
+
+uint32_t CarPhysicsBatch::Gather(const CarPhysicsState& state, const CarInput& input)
+{
+    OCT_ASSERT(mCount < MAX_CARS);
+    uint32_t i = mCount++;
+
+    mSteps[i].Load(state, input);
+
+    return i;
+}
+
+void CarPhysicsBatch::Integrate(float deltaTime)
+{
+    for (uint32_t i = 0; i < mCount; ++i)
+    {
+        CarPhysics::IntegrateBoost(mSteps[i], deltaTime);
+        CarPhysics::IntegrateVelocity(mSteps[i], deltaTime);
+    }
+}
+
+void CarPhysicsBatch::Scatter(uint32_t index, CarPhysicsState& state) const
+{
+    OCT_ASSERT(index < mCount);
+
+    mSteps[index].Store(state);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "RocketConstants.h"
+#include "CarPhysics.h"
+
+// The boost and velocity update for every simulated car in one pass.
+// Gather() each car, Integrate() them all, then Scatter() the results back.
+// Runs the same CarPhysics::IntegrateBoost() + IntegrateVelocity() as the kernel, so the results are identical.
+struct CarPhysicsBatch
+{
+    void Clear();
+    uint32_t Gather(const CarPhysicsState& state, const CarInput& input);
+    void Integrate(float deltaTime);
+    void Scatter(uint32_t index, CarPhysicsState& state) const;
+
+    uint32_t mCount = 0;
+    CarVelocityStep mSteps[MAX_CARS];
+};
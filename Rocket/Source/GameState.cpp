@@ -38,6 +38,29 @@ MatchOptions* GetMatchOptions()
     return &gGameState.mMatchOptions;
 }
 
+uint32_t GetSimSteps(float frameDeltaTime, float& outStepTime)
+{
+    if (gGameState.mMatchState != nullptr)
+    {
+        outStepTime = SIM_TIME_STEP;
+        return gGameState.mMatchState->GetSimStepCount();
+    }
+
+    outStepTime = frameDeltaTime;
+    return 1;
+}
+
+float GetSimFrameTime(float frameDeltaTime)
+{
+    if (gGameState.mSelfPlay.IsActive() &&
+        gGameState.mMatchState != nullptr)
+    {
+        return gGameState.mMatchState->GetSimStepCount() * SIM_TIME_STEP;
+    }
+
+    return frameDeltaTime;
+}
+
 void NetworkConnectCb(NetClient* newClient)
 {
     if (GetMatchState() != nullptr)
@@ -68,6 +91,13 @@ void NetworkDisconnectCb(NetClient* client)
 void GameState::Initialize()
 {
     LoadMaterials();
+
+    // Self-play already runs a match process per core.
+    if (!mSelfPlay.IsActive())
+    {
+        mTaskPool.Initialize(0);
+    }
+
     NetworkManager* netMan = NetworkManager::Get();
     netMan->SetConnectCallback(NetworkConnectCb);
     netMan->SetAcceptCallback(NetworkAcceptCb);
@@ -79,6 +109,8 @@ void GameState::Shutdown()
 {
     ShowMainMenuWidget(false);
     ShowHudWidget(false);
+    mTaskPool.Shutdown();
+    mSelfPlay.Shutdown();
 }
 
 void GameState::LoadArena()
@@ -153,7 +185,7 @@ void GameState::ShowMainMenuWidget(bool show)
 
 void GameState::ShowHudWidget(bool show)
 {
-    if (show && mHudWidget == nullptr)
+    if (show && mHudWidget == nullptr && !mHeadless)
     {
 #if PLATFORM_3DS
         mHudWidget = GetWorld(1)->SpawnNode<Hud>();
@@ -244,7 +276,12 @@ void GameState::Update(float deltaTime)
         mTransitionToMainMenu = false;
     }
 
-    UpdateMaterials(deltaTime);
+    if (!mHeadless)
+    {
+        mMaterialAnimator.Update(deltaTime);
+    }
+
+    mSelfPlay.Update();
 }
 
 void GameState::LoadMaterials()
@@ -253,19 +290,9 @@ void GameState::LoadMaterials()
     mGhWaterfallMat1 = LoadAsset("M_GH_Waterfall1");
     mGhWaterfallMat2 = LoadAsset("M_GH_Waterfall2");
     mGoalSpinnerMat = LoadAsset("M_ArenaM2_GoalSpinner");
-}
-
-void GameState::UpdateMaterials(float deltaTime)
-{
-    MaterialLite* ghWaterMat = mGhWaterMat.Get<MaterialLite>();
-    ghWaterMat->SetUvOffset(ghWaterMat->GetUvOffset() + deltaTime * glm::vec2(0.2f, 0.2f));
-
-    MaterialLite* ghWaterfallMat1 = mGhWaterfallMat1.Get<MaterialLite>();
-    ghWaterfallMat1->SetUvOffset(ghWaterfallMat1->GetUvOffset() + deltaTime * glm::vec2(0.0f, -1.0f));
-
-    MaterialLite* ghWaterfallMat2 = mGhWaterfallMat2.Get<MaterialLite>();
-    ghWaterfallMat2->SetUvOffset(ghWaterfallMat2->GetUvOffset() + deltaTime * glm::vec2(0.0f, -0.5f));
 
-    MaterialLite* spinnerMat = mGoalSpinnerMat.Get<MaterialLite>();
-    spinnerMat->SetUvOffset(spinnerMat->GetUvOffset() + deltaTime * glm::vec2(0.0f, 0.5f));
+    mMaterialAnimator.AddScroll(mGhWaterMat.Get<MaterialLite>(), glm::vec2(0.2f, 0.2f));
+    mMaterialAnimator.AddScroll(mGhWaterfallMat1.Get<MaterialLite>(), glm::vec2(0.0f, -1.0f));
+    mMaterialAnimator.AddScroll(mGhWaterfallMat2.Get<MaterialLite>(), glm::vec2(0.0f, -0.5f));
+    mMaterialAnimator.AddScroll(mGoalSpinnerMat.Get<MaterialLite>(), glm::vec2(0.0f, 0.5f));
 }
@@ -3,6 +3,9 @@
 #include "RocketConstants.h"
 #include "RocketTypes.h"
 #include "MatchState.h"
+#include "MaterialAnimator.h"
+#include "TaskPool.h"
+#include "SelfPlay.h"
 #include "Nodes/Node.h"
 #include "ObjectRef.h"
 
@@ -25,6 +28,7 @@ struct MatchOptions
     uint32_t mNumPlayers = 1;
     NetworkMode mNetworkMode = NetworkMode::Local;
     EnvironmentType mEnvironmentType = EnvironmentType::Lagoon;
+    BotDifficulty mBotDifficulty = BotDifficulty::Pro;
     bool mBots = true;
 };
 
@@ -35,8 +39,18 @@ struct GameState
     bool mMainMenuOpen = false;
     bool mTransitionToGame = false;
     bool mTransitionToMainMenu = false;
+
+    // Nothing is being rendered (simulation only), so skip purely visual work like posing car meshes.
+    bool mHeadless = false;
     NodeRef mMainMenuWidget = nullptr;
     NodeRef mHudWidget = nullptr;
+    MaterialAnimator mMaterialAnimator;
+
+    // Worker threads for parallel game work (bot planning).
+    TaskPool mTaskPool;
+
+    // Headless all-bot matches for benchmarking (SELF_PLAY builds).
+    SelfPlayRunner mSelfPlay;
 
     void Initialize();
     void Shutdown();
@@ -56,7 +70,6 @@ struct GameState
 private:
 
     void LoadMaterials();
-    void UpdateMaterials(float deltaTime);
 
     MaterialRef mGhWaterMat;
     MaterialRef mGhWaterfallMat1;
@@ -67,3 +80,11 @@ private:
 GameState* GetGameState();
 MatchState* GetMatchState();
 MatchOptions* GetMatchOptions();
+
+// Number of fixed simulation steps to run this frame (and their length).
+// Falls back to a single variable step of frameDeltaTime when no match is active.
+uint32_t GetSimSteps(float frameDeltaTime, float& outStepTime);
+
+// Game time that passed this frame. Same as frameDeltaTime, except during self-play
+// where the match runs ahead of wall time and this is the time covered by this frame's fixed steps.
+float GetSimFrameTime(float frameDeltaTime);
@@ -25,6 +25,10 @@
 
 InitOptions OctPreInitialize()
 {
+#if SELF_PLAY
+    GetGameState()->mSelfPlay.Initialize(SelfPlayOptions());
+#endif
+
     InitOptions initOptions;
     initOptions.mWidth = 1280;
     initOptions.mHeight = 720;
@@ -60,7 +64,7 @@ void OctPostInitialize()
 
     GetGameState()->Initialize();
     
-#if !EDITOR
+#if !EDITOR && !SELF_PLAY
     //GetGameState()->LoadPreferredMatchOptions();
     GetGameState()->LoadMainMenu();
 #endif
@@ -87,7 +91,13 @@ void OctPostUpdate()
 #if 1
     GetGameState()->Update(GetAppClock()->DeltaTime());
 
-#if !EDITOR
+#if SELF_PLAY
+    if (GetGameState()->mSelfPlay.IsDone())
+    {
+        // Let the engine shut down normally, OctPreShutdown() shuts down the game state and waits for the workers.
+        Quit();
+    }
+#elif !EDITOR
     // Exit the game if home is pressed or the Smash Bros Melee reset combo is pressed.
     if (IsGamepadButtonDown(GAMEPAD_HOME, 0) ||
         (IsGamepadButtonDown(GAMEPAD_A, 0) &&
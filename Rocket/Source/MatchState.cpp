@@ -13,11 +13,14 @@
 #include "NetworkManager.h"
 #include "World.h"
 #include "Log.h"
+#include "Maths.h"
 #include "InputDevices.h"
 #include "Assets/Material.h"
 
 #include "System/System.h"
 
+#include "Bullet/btBulletDynamicsCommon.h"
+
 DEFINE_NODE(MatchState, Node3D);
 
 MatchState::MatchState()
@@ -46,6 +49,7 @@ void MatchState::Create()
 
 void MatchState::Destroy()
 {
+    FinishBotDecisions();
     Node3D::Destroy();
 
     if (IsPlaying())
@@ -65,13 +69,33 @@ void MatchState::Start()
 
     FindSpawnPointActors();
     PostLoadHandlePlatformTier();
+    LoadArenaSdf();
+
+    if (GetGameState()->mSelfPlay.IsActive())
+    {
+        mAnalyticBallPhysics = GetGameState()->mSelfPlay.GetOptions().mAnalyticBallPhysics;
+        mBotPlanning = GetGameState()->mSelfPlay.GetOptions().mBotPlanning;
+    }
+
+    if (mAnalyticBallPhysics &&
+        !mArenaSdf.IsLoaded())
+    {
+        LogWarning("Analytic ball physics needs an arena SDF, colliding the ball through Bullet instead");
+        mAnalyticBallPhysics = false;
+    }
 
     if (NetIsAuthority())
     {
+        mNavGrid.Build(mArenaSdf.IsLoaded() ? &mArenaSdf : nullptr);
+
+        mBotDecisions.Load("Assets/Data/BotDecisions.txt");
+
         // Spawn Ball
         {
             Ball* ball = GetWorld()->SpawnNode<Ball>();
-            ball->SetPosition(glm::vec3(0.0f, 8.0f, 0.0f));
+            ball->SetSimPosition(glm::vec3(0.0f, 8.0f, 0.0f));
+            ball->ResetInterpolation();
+            ball->EnableAnalyticPhysics(mAnalyticBallPhysics);
             ball->UpdateTransform(true);
         }
 
@@ -116,6 +140,7 @@ void MatchState::Start()
 void MatchState::ResetMatchState()
 {
     OCT_ASSERT(NetIsAuthority());
+    FinishBotDecisions();
     mBall = GetWorld()->FindNode("Ball")->As<Ball>();
     mTime = GetGameState()->mMatchOptions.mDuration;
     mTeamSize = GetGameState()->mMatchOptions.mTeamSize;
@@ -123,12 +148,16 @@ void MatchState::ResetMatchState()
 
     mPhaseTime = 0.0f;
     mOvertime = false;
+    mNumGoalVolumes = 0;
+    mGoalCheckValid = false;
+    mBotScheduler.Reset();
 
 
     // Assign cars, full boosts, spawns, and goals
     const std::vector<Node*> nodes = GetWorld()->GatherNodes();
     mNumCars = 0;
     uint32_t boostCount = 0;
+    std::vector<BoostPickup*> pickups;
 
     for (uint32_t i = 0; i < nodes.size(); ++i)
     {
@@ -157,6 +186,8 @@ void MatchState::ResetMatchState()
             default: behavior = BotBehavior::Offense; break;
             }
             car->SetBotBehavior(behavior);
+            car->SetBotDifficulty(GetMatchOptions()->mBotDifficulty);
+            car->SetBotSeed(mNumCars);
 
             if (mNumCars == 0)
             {
@@ -170,6 +201,11 @@ void MatchState::ResetMatchState()
 
         BoostPickup* pickup = nodes[i]->As<BoostPickup>();
 
+        if (pickup != nullptr)
+        {
+            pickups.push_back(pickup);
+        }
+
         if (boostCount < NUM_FULL_BOOSTS &&
             pickup != nullptr)
         {
@@ -190,11 +226,14 @@ void MatchState::ResetMatchState()
                 if (teamIndex == 0 || teamIndex == 1)
                 {
                     mGoalBoxes[teamIndex] = nodes[i]->As<Node3D>();
+                    RegisterGoal(mGoalBoxes[teamIndex], teamIndex);
                 }
             }
         }
     }
 
+    mBoostIndex.Build(pickups.data(), uint32_t(pickups.size()));
+
     AssignCarHostIds();
 
     SetupKickoff();
@@ -210,13 +249,27 @@ void MatchState::Tick(float deltaTime)
         mBall = GetWorld()->FindNode("Ball")->As<Ball>();
     }
 
+    // Last frame's bot decisions read the ball prediction and blackboards, so finish them before those change.
+    FinishBotDecisions();
+
+    UpdateSimClock(deltaTime);
+    deltaTime = GetSimFrameTime(deltaTime);
+    UpdateBallPrediction(deltaTime);
+    UpdateBotBlackboards();
+    mBotScheduler.Update(mCars, mNumCars, deltaTime);
+    StartBotDecisions(deltaTime);
+
+    UpdateSimulation(deltaTime);
+
     if (NetIsAuthority())
     {
         mPhaseTime += deltaTime;
+        UpdateGoalCheck();
     }
 
     // Only show countdown text during Countdown phase
-    if (GetGameState()->mHudWidget.Get()->IsVisible() &&
+    if (GetGameState()->mHudWidget != nullptr &&
+        GetGameState()->mHudWidget.Get()->IsVisible() &&
         mPhase != MatchPhase::Countdown)
     {
         GetGameState()->mHudWidget.Get<Hud>()->SetCountdownTime(0);
@@ -239,7 +292,7 @@ void MatchState::Tick(float deltaTime)
         {
             SetMatchPhase(MatchPhase::Play);
         }
-        else
+        else if (GetGameState()->mHudWidget != nullptr)
         {
             int32_t countTime = int32_t(3.0f - mPhaseTime) + 1;
             countTime = glm::clamp<int32_t>(countTime, 1, 3);
@@ -297,7 +350,18 @@ void MatchState::Tick(float deltaTime)
         if (NetIsAuthority() &&
             mPhaseTime >= 2.0f)
         {
-            if (IsGamepadButtonJustDown(GAMEPAD_B, 0))
+            if (GetGameState()->mSelfPlay.IsActive())
+            {
+                if (GetGameState()->mSelfPlay.FinishMatch(this))
+                {
+                    ResetMatchState();
+                }
+                else
+                {
+                    SetMatchPhase(MatchPhase::Count);
+                }
+            }
+            else if (IsGamepadButtonJustDown(GAMEPAD_B, 0))
             {
                 // Quit to menu
             }
@@ -355,6 +419,40 @@ void MatchState::AssignHostToCar(NetClient* client)
     }
 }
 
+bool MatchState::IsCarSteppedByMatch(const Car* car) const
+{
+    for (uint32_t i = 0; i < mNumCars; ++i)
+    {
+        if (mCars[i] == car)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool MatchState::IsCarBroadphaseActive() const
+{
+    // Bumps and demos are only decided by the authority. Clients keep colliding cars through Bullet.
+    return mCarBroadphase && NetIsAuthority();
+}
+
+uint32_t MatchState::GetSimStepCount() const
+{
+    return mSimStepCount;
+}
+
+uint32_t MatchState::GetSimTick() const
+{
+    return mSimTick;
+}
+
+float MatchState::GetSimAlpha() const
+{
+    return mSimAlpha;
+}
+
 bool MatchState::IsMatchOngoing() const
 {
     return mPhase != MatchPhase::Count;
@@ -373,6 +471,24 @@ void MatchState::FindSpawnPointActors()
     mSpawnPoints1[2] = GetWorld()->FindNode("Spawn.1.2")->As<Node3D>();
 }
 
+void MatchState::LoadArenaSdf()
+{
+    bool lagoon = (GetMatchOptions()->mEnvironmentType == EnvironmentType::Lagoon);
+    const char* sdfPath = lagoon ? "Assets/Collision/SDF_Lagoon.dat" : "Assets/Collision/SDF_Arena.dat";
+
+    if (!mArenaSdf.Load(sdfPath))
+    {
+#if EDITOR
+        // Baking is an offline step, play each arena once in the editor and commit the saved file.
+        LogDebug("Baking arena SDF %s", sdfPath);
+        mArenaSdf.Bake(GetWorld(), ColGroupEnvironment);
+        mArenaSdf.Save(sdfPath);
+#else
+        LogWarning("Arena SDF %s is missing, bake it in the editor. Colliding through Bullet instead", sdfPath);
+#endif
+    }
+}
+
 void MatchState::PostLoadHandlePlatformTier()
 {
     // For now, turn off particles on Old 3DS (Tier 0)
@@ -445,6 +561,9 @@ void MatchState::SetupKickoff()
 {
     OCT_ASSERT(NetIsAuthority());
 
+    // Cars reset their bot state below, which this frame's decisions may still be reading.
+    FinishBotDecisions();
+
     mBall->Reset();
 
     for (uint32_t t = 0; t < NUM_TEAMS; ++t)
@@ -522,3 +641,400 @@ void MatchState::AssignCarHostIds()
         }
     }
 }
+
+void MatchState::UpdateSimClock(float deltaTime)
+{
+    // Self-play doesn't wait for wall time, every frame is a full set of steps.
+    if (GetGameState()->mSelfPlay.IsActive())
+    {
+        deltaTime = SIM_MAX_STEPS_PER_FRAME * SIM_TIME_STEP;
+    }
+
+    mSimAccumulator += deltaTime;
+    mSimStepCount = 0;
+
+    while (mSimAccumulator >= SIM_TIME_STEP &&
+        mSimStepCount < SIM_MAX_STEPS_PER_FRAME)
+    {
+        mSimAccumulator -= SIM_TIME_STEP;
+        ++mSimStepCount;
+        ++mSimTick;
+    }
+
+    // If we are too far behind (long hitch / loading), drop the time instead of spiraling.
+    mSimAccumulator = glm::min(mSimAccumulator, SIM_TIME_STEP);
+    mSimAlpha = glm::clamp(mSimAccumulator / SIM_TIME_STEP, 0.0f, 1.0f);
+}
+
+void MatchState::UpdateSimulation(float deltaTime)
+{
+    Car* simCars[MAX_CARS] = {};
+    Car* remoteCars[MAX_CARS] = {};
+    uint32_t numSimCars = 0;
+    uint32_t numRemoteCars = 0;
+
+    for (uint32_t i = 0; i < mNumCars; ++i)
+    {
+        if (mCars[i] == nullptr)
+        {
+            continue;
+        }
+
+        if (mCars[i]->IsSimulatedLocally())
+        {
+            // Input is gathered once per frame and shared by all of this frame's steps.
+            mCars[i]->UpdateControlInput(deltaTime);
+            simCars[numSimCars] = mCars[i];
+            ++numSimCars;
+        }
+        else if (NetIsAuthority())
+        {
+            // Client cars are moved on the server to determine demolitions, bumps and ball hits.
+            mCars[i]->BeginRemoteMotion();
+            remoteCars[numRemoteCars] = mCars[i];
+            ++numRemoteCars;
+        }
+    }
+
+    // The ball steps after the cars each step, so car touches see where it was at the start of the step.
+    bool stepBall = (NetIsAuthority() && mBall != nullptr);
+
+    for (uint32_t step = 0; step < mSimStepCount; ++step)
+    {
+        if (stepBall)
+        {
+            mBall->BeginSimStep();
+        }
+
+        mCarBatch.Clear();
+
+        for (uint32_t i = 0; i < numSimCars; ++i)
+        {
+            simCars[i]->BeginPhysicsStep(SIM_TIME_STEP);
+
+            if (mBatchCarPhysics)
+            {
+                mCarBatch.Gather(simCars[i]->GetPhysicsState(), simCars[i]->GetCurrentInput());
+            }
+        }
+
+        if (mBatchCarPhysics)
+        {
+            mCarBatch.Integrate(SIM_TIME_STEP);
+        }
+
+        for (uint32_t i = 0; i < numSimCars; ++i)
+        {
+            if (mBatchCarPhysics)
+            {
+                mCarBatch.Scatter(i, simCars[i]->GetPhysicsState());
+            }
+            else
+            {
+                CarPhysics::UpdateBoost(simCars[i]->GetPhysicsState(), simCars[i]->GetCurrentInput(), SIM_TIME_STEP);
+                CarPhysics::UpdateVelocity(simCars[i]->GetPhysicsState(), simCars[i]->GetCurrentInput(), SIM_TIME_STEP);
+            }
+
+            simCars[i]->EndPhysicsStep(SIM_TIME_STEP);
+        }
+
+        for (uint32_t i = 0; i < numRemoteCars; ++i)
+        {
+            remoteCars[i]->UpdateMotion(SIM_TIME_STEP);
+        }
+
+        // Car sweeps skip the car group, so pairs have to be resolved after every step or cars pass through each other.
+        if (IsCarBroadphaseActive())
+        {
+            UpdateCarPairs();
+        }
+
+        if (stepBall)
+        {
+            mBall->UpdateSimulation(SIM_TIME_STEP);
+        }
+    }
+
+    for (uint32_t i = 0; i < numRemoteCars; ++i)
+    {
+        remoteCars[i]->EndRemoteMotion();
+    }
+
+    if (stepBall)
+    {
+        mBall->UpdateVisualTransform(mSimAlpha);
+    }
+}
+
+void MatchState::UpdateCarPairs()
+{
+    mCarHash.Clear();
+
+    for (uint32_t i = 0; i < mNumCars; ++i)
+    {
+        if (mCars[i] != nullptr &&
+            mCars[i]->IsAlive())
+        {
+            mCarHash.Insert(mCars[i]->GetPosition(), mCars[i]->GetRadius(), mCars[i]);
+        }
+    }
+
+    const uint32_t kMaxCarPairs = (MAX_CARS * (MAX_CARS - 1)) / 2;
+    SpatialHashPair pairs[kMaxCarPairs];
+    uint32_t numPairs = mCarHash.FindPairs(0.0f, pairs, kMaxCarPairs);
+
+    for (uint32_t i = 0; i < numPairs; ++i)
+    {
+        Car* carA = (Car*)mCarHash.GetUserData(pairs[i].mA);
+        Car* carB = (Car*)mCarHash.GetUserData(pairs[i].mB);
+
+        // A previous pair may have demolished one of these.
+        if (!carA->IsAlive() || !carB->IsAlive())
+        {
+            continue;
+        }
+
+        glm::vec3 posA = carA->GetPosition();
+        glm::vec3 posB = carB->GetPosition();
+        glm::vec3 normal = Maths::SafeNormalize(posA - posB);
+
+        // Only resolve cars that are moving into each other, bumps push them apart.
+        if (glm::dot(carA->GetVelocity() - carB->GetVelocity(), normal) < 0.0f)
+        {
+            // Whoever drove into the other decides the outcome, same as when their sweep hit the other car.
+            float dotA = fabs(glm::dot(normal, carA->GetVelocity()));
+            float dotB = fabs(glm::dot(normal, carB->GetVelocity()));
+
+            if (dotA >= dotB)
+            {
+                carA->HandleCarContact(carB, normal);
+            }
+            else
+            {
+                carB->HandleCarContact(carA, -normal);
+            }
+        }
+
+        // Cars no longer block each other in their sweeps, so push apart any overlap.
+        float penetration = (carA->GetRadius() + carB->GetRadius()) - glm::distance(posA, posB);
+        if (penetration > 0.0f &&
+            carA->IsAlive() &&
+            carB->IsAlive())
+        {
+            carA->SetPosition(posA + normal * (penetration * 0.5f));
+            carB->SetPosition(posB - normal * (penetration * 0.5f));
+        }
+    }
+}
+
+void MatchState::UpdateBallPrediction(float deltaTime)
+{
+    mPredictionTime += deltaTime;
+
+    if (mBall == nullptr ||
+        deltaTime <= 0.0f)
+    {
+        mBallPredictor.Invalidate();
+        return;
+    }
+
+    glm::vec3 position = mBall->GetSimPosition();
+    glm::vec3 velocity = {};
+
+    if (NetIsAuthority())
+    {
+        velocity = mBall->GetVelocity();
+    }
+    else
+    {
+        // The ball isn't simulated on clients, estimate its velocity from the replicated position.
+        velocity = (position - mPrevBallPosition) / deltaTime;
+    }
+
+    mPrevBallPosition = position;
+
+    btVector3 gravity = GetWorld()->GetDynamicsWorld()->getGravity();
+    mBallPredictor.SetArenaSdf(mArenaSdf.IsLoaded() ? &mArenaSdf : nullptr);
+    mBallPredictor.Update(position, velocity, glm::vec3(gravity.x(), gravity.y(), gravity.z()), mPredictionTime);
+}
+
+bool GoalVolume::IntersectsSegment(glm::vec3 start, glm::vec3 end) const
+{
+    // Slab test in the volume's local space
+    glm::vec3 startOffset = start - mCenter;
+    glm::vec3 delta = end - start;
+    float tMin = 0.0f;
+    float tMax = 1.0f;
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        float origin = glm::dot(startOffset, mAxes[i]);
+        float dir = glm::dot(delta, mAxes[i]);
+
+        if (fabs(dir) < 0.0001f)
+        {
+            if (fabs(origin) > mHalfExtents[i])
+            {
+                return false;
+            }
+        }
+        else
+        {
+            float t0 = (-mHalfExtents[i] - origin) / dir;
+            float t1 = (mHalfExtents[i] - origin) / dir;
+            tMin = glm::max(tMin, glm::min(t0, t1));
+            tMax = glm::min(tMax, glm::max(t0, t1));
+
+            if (tMin > tMax)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void MatchState::UpdateBotBlackboards()
+{
+    if (!NetIsAuthority() ||
+        mBall == nullptr)
+    {
+        return;
+    }
+
+    mBoostIndex.Update();
+
+    for (uint32_t i = 0; i < NUM_TEAMS; ++i)
+    {
+        mBotBlackboards[i].Update(i, this);
+    }
+}
+
+bool MatchState::IsBotDecisionParallel() const
+{
+    return mParallelBotDecisions &&
+        GetGameState()->mTaskPool.GetNumThreads() > 0;
+}
+
+void MatchState::StartBotDecisions(float deltaTime)
+{
+    if (!IsBotDecisionParallel())
+    {
+        return;
+    }
+
+    mNumBotDecisionCars = 0;
+
+    for (uint32_t i = 0; i < mNumCars; ++i)
+    {
+        Car* car = mCars[i];
+
+        if (car != nullptr &&
+            car->IsBot() &&
+            car->IsSimulatedLocally() &&
+            car->IsControlEnabled())
+        {
+            car->BeginBotDecision(deltaTime);
+            mBotDecisionCars[mNumBotDecisionCars] = car;
+            ++mNumBotDecisionCars;
+        }
+    }
+
+    GetGameState()->mTaskPool.Dispatch(BotDecisionTask, this, mNumBotDecisionCars);
+}
+
+void MatchState::FinishBotDecisions()
+{
+    if (mNumBotDecisionCars == 0)
+    {
+        return;
+    }
+
+    GetGameState()->mTaskPool.Wait();
+
+    for (uint32_t i = 0; i < mNumBotDecisionCars; ++i)
+    {
+        mBotDecisionCars[i]->EndBotDecision();
+    }
+
+    mNumBotDecisionCars = 0;
+}
+
+void MatchState::BotDecisionTask(void* data, uint32_t index)
+{
+    MatchState* match = (MatchState*)data;
+
+    // Rollouts run inline here, the workers are already busy with the other bots.
+    match->mBotDecisionCars[index]->BotDecide(nullptr);
+}
+
+void MatchState::RegisterGoal(Node3D* goal, uint32_t team)
+{
+    Primitive3D* prim = goal->As<Primitive3D>();
+
+    if (prim == nullptr ||
+        prim->GetRigidBody() == nullptr ||
+        mNumGoalVolumes >= NUM_TEAMS)
+    {
+        LogWarning("Goal %s has no collision, it can't be scored on.", goal->GetName().c_str());
+        return;
+    }
+
+    // Take the box from the same Bullet shape the old overlap test used.
+    btRigidBody* body = prim->GetRigidBody();
+    btTransform identity;
+    identity.setIdentity();
+    btVector3 localMin;
+    btVector3 localMax;
+    body->getCollisionShape()->getAabb(identity, localMin, localMax);
+
+    const btTransform& transform = body->getWorldTransform();
+    btVector3 localCenter = (localMin + localMax) * 0.5f;
+    btVector3 center = transform * localCenter;
+    btVector3 halfExtents = (localMax - localMin) * 0.5f;
+
+    GoalVolume& volume = mGoalVolumes[mNumGoalVolumes];
+    volume.mCenter = glm::vec3(center.x(), center.y(), center.z());
+    volume.mHalfExtents = glm::vec3(halfExtents.x(), halfExtents.y(), halfExtents.z());
+    volume.mTeam = team;
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        btVector3 axis = transform.getBasis().getColumn(i);
+        volume.mAxes[i] = glm::vec3(axis.x(), axis.y(), axis.z());
+    }
+
+    ++mNumGoalVolumes;
+
+    // Scoring is tested in UpdateGoalCheck(), the trigger no longer needs overlap callbacks.
+    prim->EnableOverlaps(false);
+}
+
+void MatchState::UpdateGoalCheck()
+{
+    if (mBall == nullptr ||
+        !mBall->IsAlive())
+    {
+        mGoalCheckValid = false;
+        return;
+    }
+
+    // Test the path the ball center took since last frame so a fast ball can't skip over a goal.
+    glm::vec3 position = mBall->GetSimPosition();
+    glm::vec3 prevPosition = mGoalCheckValid ? mGoalCheckPosition : position;
+    mGoalCheckPosition = position;
+    mGoalCheckValid = true;
+
+    for (uint32_t i = 0; i < mNumGoalVolumes; ++i)
+    {
+        if (mGoalVolumes[i].IntersectsSegment(prevPosition, position))
+        {
+            uint32_t scoringTeam = (mGoalVolumes[i].mTeam + 1) % NUM_TEAMS;
+            HandleGoal(scoringTeam);
+            mBall->Explode();
+            mGoalCheckValid = false;
+            break;
+        }
+    }
+}
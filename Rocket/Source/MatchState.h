@@ -2,6 +2,15 @@
 
 #include "RocketConstants.h"
 #include "RocketTypes.h"
+#include "CarPhysicsBatch.h"
+#include "ArenaSdf.h"
+#include "SpatialHash.h"
+#include "BallPredictor.h"
+#include "BotScheduler.h"
+#include "BotBlackboard.h"
+#include "BoostIndex.h"
+#include "NavGrid.h"
+#include "BotDecisionTable.h"
 
 #include "Nodes/Node.h"
 #include "Nodes/3D/Node3d.h"
@@ -27,6 +36,17 @@ struct Team
     Car* mCars[MAX_TEAM_SIZE] = {};
 };
 
+// Oriented box the ball center must enter to score on mTeam's goal.
+struct GoalVolume
+{
+    glm::vec3 mCenter = {};
+    glm::vec3 mAxes[3] = {};
+    glm::vec3 mHalfExtents = {};
+    uint32_t mTeam = 0;
+
+    bool IntersectsSegment(glm::vec3 start, glm::vec3 end) const;
+};
+
 class MatchState : public Node3D
 {
 public:
@@ -42,6 +62,14 @@ public:
 
     void HandleGoal(uint32_t scoringTeam);
     void AssignHostToCar(NetClient* client);
+    bool IsCarSteppedByMatch(const Car* car) const;
+    bool IsCarBroadphaseActive() const;
+    bool IsBotDecisionParallel() const;
+    void FinishBotDecisions();
+
+    uint32_t GetSimStepCount() const;
+    uint32_t GetSimTick() const;
+    float GetSimAlpha() const;
 
 protected:
 
@@ -53,6 +81,16 @@ protected:
     void EnableCarControl(bool enable);
     bool IsMatchOngoing() const;
     void AssignCarHostIds();
+    void UpdateSimClock(float deltaTime);
+    void UpdateSimulation(float deltaTime);
+    void LoadArenaSdf();
+    void UpdateCarPairs();
+    void UpdateBallPrediction(float deltaTime);
+    void UpdateBotBlackboards();
+    void StartBotDecisions(float deltaTime);
+    static void BotDecisionTask(void* data, uint32_t index);
+    void RegisterGoal(Node3D* goal, uint32_t team);
+    void UpdateGoalCheck();
 
 public:
 
@@ -67,6 +105,10 @@ public:
     MatchPhase mPhase = MatchPhase::Count;
 
     Node3D* mGoalBoxes[NUM_TEAMS] = {};
+    GoalVolume mGoalVolumes[NUM_TEAMS] = {};
+    uint32_t mNumGoalVolumes = 0;
+    glm::vec3 mGoalCheckPosition = {};
+    bool mGoalCheckValid = false;
     Node3D* mFullBoosts[NUM_FULL_BOOSTS] = {};
     Node3D* mSpawnPoints0[NUM_SPAWN_POINTS] = {};
     Node3D* mSpawnPoints1[NUM_SPAWN_POINTS] = {};
@@ -74,6 +116,56 @@ public:
     float mPhaseTime = 0.0f;
     bool mOvertime = false;
 
+    // Fixed-rate simulation clock. Cars and ball step SIM_TIME_STEP at a time in UpdateSimulation(),
+    // mSimStepCount times per frame, and render mSimAlpha of the way into the next step.
+    float mSimAccumulator = 0.0f;
+    float mSimAlpha = 0.0f;
+    uint32_t mSimStepCount = 0;
+    uint32_t mSimTick = 0;
+
+    // Step all locally simulated cars' boost/velocity in one pass instead of car by car.
+    bool mBatchCarPhysics = true;
+    CarPhysicsBatch mCarBatch;
+
+    // Car-car bumps and demos are found by hashing car positions each step instead of by Bullet sweeps.
+    bool mCarBroadphase = true;
+    SpatialHash mCarHash;
+
+    // Shared ball path prediction, see BallPredictor.
+    BallPredictor mBallPredictor;
+    float mPredictionTime = 0.0f;
+    glm::vec3 mPrevBallPosition = {};
+
+    // Decides which bots re-evaluate their target each frame.
+    BotScheduler mBotScheduler;
+
+    // Let bots plan ball touches with BotPlanner rollouts (see Car::SetBotRolloutBudget()).
+    bool mBotPlanning = false;
+
+    // Bots decide on TaskPool workers during the frame and their cars use the result next frame.
+    bool mParallelBotDecisions = true;
+    Car* mBotDecisionCars[MAX_CARS] = {};
+    uint32_t mNumBotDecisionCars = 0;
+
+    // Shared per-team bot knowledge, rebuilt every frame before bots think.
+    BotBlackboard mBotBlackboards[NUM_TEAMS];
+
+    // Every boost pad and when it respawns, for bot boost routing.
+    BoostIndex mBoostIndex;
+
+    // Collide the ball with the arena SDF instead of querying Bullet. Deterministic, and matches the prediction exactly.
+    // Only allowed when the SDF is loaded.
+    bool mAnalyticBallPhysics = false;
+
+    // Environment collision for car sweeps, replaces Bullet queries against the arena mesh when loaded.
+    ArenaSdf mArenaSdf;
+
+    // Bot steering around walls and goal posts, built from mArenaSdf.
+    NavGrid mNavGrid;
+
+    // Bot target selection for each behavior, compiled from Assets/Data/BotDecisions.txt.
+    BotDecisions mBotDecisions;
+
 
     // If editing, make sure to update ResetMatchState()
 };
@@ -0,0 +1,167 @@
+#include "MaterialAnimator.h"
+
+#include "Maths.h"
+#include "Log.h"
+#include "Assertion.h"
+#include "Assets/MaterialLite.h"
+
+// How close a damped value has to get to its target before the track stops.
+const float DampSettleDistance = 0.001f;
+
+int32_t MaterialAnimator::AddScroll(MaterialLite* material, glm::vec2 rate)
+{
+    int32_t track = AddTrack(material, MaterialParam::UvOffset, MaterialCurve::Scroll);
+
+    if (track != INVALID_MATERIAL_TRACK)
+    {
+        mTracks[track].mRate = glm::vec4(rate, 0.0f, 0.0f);
+    }
+
+    return track;
+}
+
+int32_t MaterialAnimator::AddDamp(MaterialLite* material, MaterialParam param, glm::vec4 target, float smoothing)
+{
+    int32_t track = AddTrack(material, param, MaterialCurve::Damp);
+
+    if (track != INVALID_MATERIAL_TRACK)
+    {
+        mTracks[track].mSmoothing = smoothing;
+        SetTarget(track, target);
+    }
+
+    return track;
+}
+
+void MaterialAnimator::RemoveTrack(int32_t track)
+{
+    if (track >= 0 &&
+        track < int32_t(mNumTracks))
+    {
+        mTracks[track] = MaterialTrack();
+
+        while (mNumTracks > 0 &&
+            mTracks[mNumTracks - 1].mMaterial == nullptr)
+        {
+            --mNumTracks;
+        }
+    }
+}
+
+void MaterialAnimator::Clear()
+{
+    for (uint32_t i = 0; i < mNumTracks; ++i)
+    {
+        mTracks[i] = MaterialTrack();
+    }
+
+    mNumTracks = 0;
+}
+
+void MaterialAnimator::SetTarget(int32_t track, glm::vec4 target)
+{
+    OCT_ASSERT(track >= 0 && track < int32_t(mNumTracks));
+    MaterialTrack& t = mTracks[track];
+
+    if (t.mTarget != target)
+    {
+        t.mTarget = target;
+        t.mActive = true;
+    }
+}
+
+void MaterialAnimator::Update(float deltaTime)
+{
+    for (uint32_t i = 0; i < mNumTracks; ++i)
+    {
+        MaterialTrack& track = mTracks[i];
+
+        if (!track.mActive)
+        {
+            continue;
+        }
+
+        switch (track.mCurve)
+        {
+        case MaterialCurve::Scroll:
+            track.mValue += track.mRate * deltaTime;
+            break;
+
+        case MaterialCurve::Damp:
+            track.mValue = Maths::Damp(track.mValue, track.mTarget, track.mSmoothing, deltaTime);
+
+            if (glm::distance(track.mValue, track.mTarget) < DampSettleDistance)
+            {
+                track.mValue = track.mTarget;
+                track.mActive = false;
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        Apply(track);
+    }
+}
+
+int32_t MaterialAnimator::AddTrack(MaterialLite* material, MaterialParam param, MaterialCurve curve)
+{
+    if (material == nullptr)
+    {
+        return INVALID_MATERIAL_TRACK;
+    }
+
+    int32_t index = INVALID_MATERIAL_TRACK;
+
+    for (uint32_t i = 0; i < mNumTracks; ++i)
+    {
+        if (mTracks[i].mMaterial == nullptr)
+        {
+            index = int32_t(i);
+            break;
+        }
+    }
+
+    if (index == INVALID_MATERIAL_TRACK)
+    {
+        if (mNumTracks >= MAX_MATERIAL_TRACKS)
+        {
+            LogWarning("Out of material tracks, %s won't be animated.", material->GetName().c_str());
+            return INVALID_MATERIAL_TRACK;
+        }
+
+        index = int32_t(mNumTracks);
+        ++mNumTracks;
+    }
+
+    MaterialTrack& track = mTracks[index];
+    track = MaterialTrack();
+    track.mMaterialRef = material;
+    track.mMaterial = material;
+    track.mParam = param;
+    track.mCurve = curve;
+    track.mActive = true;
+
+    // Read the starting value once, from here on the track owns it.
+    switch (param)
+    {
+    case MaterialParam::UvOffset: track.mValue = glm::vec4(material->GetUvOffset(), 0.0f, 0.0f); break;
+    case MaterialParam::FresnelColor: track.mValue = material->GetFresnelColor(); break;
+    default: break;
+    }
+
+    track.mTarget = track.mValue;
+
+    return index;
+}
+
+void MaterialAnimator::Apply(const MaterialTrack& track)
+{
+    switch (track.mParam)
+    {
+    case MaterialParam::UvOffset: track.mMaterial->SetUvOffset(glm::vec2(track.mValue)); break;
+    case MaterialParam::FresnelColor: track.mMaterial->SetFresnelColor(track.mValue); break;
+    default: break;
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "AssetRef.h"
+
+#include <stdint.h>
+#include <glm/glm.hpp>
+
+class MaterialLite;
+
+#define MAX_MATERIAL_TRACKS 32
+#define INVALID_MATERIAL_TRACK -1
+
+enum class MaterialParam
+{
+    UvOffset,
+    FresnelColor,
+
+    Count
+};
+
+enum class MaterialCurve
+{
+    // Move at mRate forever.
+    Scroll,
+
+    // Damp towards mTarget, stopping once it gets there.
+    Damp,
+
+    Count
+};
+
+struct MaterialTrack
+{
+    MaterialRef mMaterialRef;
+    MaterialLite* mMaterial = nullptr;
+    MaterialParam mParam = MaterialParam::Count;
+    MaterialCurve mCurve = MaterialCurve::Count;
+    glm::vec4 mValue = {};
+    glm::vec4 mTarget = {};
+    glm::vec4 mRate = {};
+    float mSmoothing = 0.0f;
+    bool mActive = false;
+};
+
+// Animates material parameters for the whole game in one pass over a flat array of tracks.
+// The current value lives in the track, so materials are only ever written to, never looked up or read.
+class MaterialAnimator
+{
+public:
+
+    int32_t AddScroll(MaterialLite* material, glm::vec2 rate);
+    int32_t AddDamp(MaterialLite* material, MaterialParam param, glm::vec4 target, float smoothing);
+    void RemoveTrack(int32_t track);
+    void Clear();
+
+    void SetTarget(int32_t track, glm::vec4 target);
+
+    void Update(float deltaTime);
+
+protected:
+
+    int32_t AddTrack(MaterialLite* material, MaterialParam param, MaterialCurve curve);
+    void Apply(const MaterialTrack& track);
+
+    MaterialTrack mTracks[MAX_MATERIAL_TRACKS];
+    uint32_t mNumTracks = 0;
+};
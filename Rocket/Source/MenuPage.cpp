@@ -213,14 +213,23 @@ void MenuPageCreate::Create()
         "Online"
     };
 
+    static const char* botDifficultyStrings[3] =
+    {
+        "Rookie",
+        "Pro",
+        "All-Star"
+    };
+
     mTeamSizeOption = CreateOption<MenuOptionEnum>("Team Size", nullptr);
     mEnvironmentOption = CreateOption<MenuOptionEnum>("Stage", nullptr);
     mNetworkOption = CreateOption<MenuOptionEnum>("Network", nullptr);
+    mBotDifficultyOption = CreateOption<MenuOptionEnum>("Bots", nullptr);
     mStartOption = CreateOption<MenuOption>("Start", ActivateStart);
 
     mTeamSizeOption->SetEnumData(3, teamSizeStrings);
     mEnvironmentOption->SetEnumData(2, environmentStrings);
     mNetworkOption->SetEnumData(3, networkStrings);
+    mBotDifficultyOption->SetEnumData(3, botDifficultyStrings);
 
 
     PullOptions();
@@ -239,6 +248,7 @@ void MenuPageCreate::PullOptions()
     mTeamSizeOption->SetEnumValue(GetGameState()->mMatchOptions.mTeamSize - 1);
     mEnvironmentOption->SetEnumValue((uint32_t)GetGameState()->mMatchOptions.mEnvironmentType);
     mNetworkOption->SetEnumValue((uint32_t)GetGameState()->mMatchOptions.mNetworkMode);
+    mBotDifficultyOption->SetEnumValue((uint32_t)GetGameState()->mMatchOptions.mBotDifficulty);
 }
 
 void MenuPageCreate::PushOptions()
@@ -246,6 +256,7 @@ void MenuPageCreate::PushOptions()
     GetGameState()->mMatchOptions.mTeamSize = mTeamSizeOption->GetEnumValue() + 1;
     GetGameState()->mMatchOptions.mEnvironmentType = (EnvironmentType)mEnvironmentOption->GetEnumValue();
     GetGameState()->mMatchOptions.mNetworkMode = (NetworkMode)mNetworkOption->GetEnumValue();
+    GetGameState()->mMatchOptions.mBotDifficulty = (BotDifficulty)mBotDifficultyOption->GetEnumValue();
 }
 
 void MenuPageAbout::Create()
@@ -88,6 +88,7 @@ public:
     MenuOptionEnum* mTeamSizeOption = nullptr;
     MenuOptionEnum* mEnvironmentOption = nullptr;
     MenuOptionEnum* mNetworkOption = nullptr;
+    MenuOptionEnum* mBotDifficultyOption = nullptr;
     MenuOption* mStartOption = nullptr;
 };
 
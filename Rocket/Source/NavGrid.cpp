@@ -0,0 +1,273 @@
+#include "NavGrid.h"
+#include "ArenaSdf.h"
+#include "RocketConstants.h"
+
+#include "Log.h"
+
+// 8-connected, in order: +X, +X+Z, +Z, -X+Z, -X, -X-Z, -Z, +X-Z
+const int32_t NavDirX[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+const int32_t NavDirZ[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+void NavGrid::Build(const ArenaSdf* sdf)
+{
+    Clear();
+
+    glm::vec3 boundsMin = glm::vec3(-ARENA_EXTENT_X, 0.0f, -ARENA_EXTENT_Z);
+    glm::vec3 boundsMax = glm::vec3(ARENA_EXTENT_X, ARENA_EXTENT_Y, ARENA_EXTENT_Z);
+
+    if (sdf != nullptr)
+    {
+        // The SDF covers the goal mouths too.
+        boundsMin = sdf->GetBoundsMin();
+        boundsMax = sdf->GetBoundsMax();
+    }
+
+    glm::vec3 size = boundsMax - boundsMin;
+    mCellSize = NAV_CELL_SIZE;
+
+    while (int32_t(size.x / mCellSize) * int32_t(size.z / mCellSize) > NAV_MAX_CELLS)
+    {
+        mCellSize *= 1.25f;
+    }
+
+    mOrigin = boundsMin;
+    mDimX = glm::max(int32_t(size.x / mCellSize), 1);
+    mDimZ = glm::max(int32_t(size.z / mCellSize), 1);
+
+    int32_t numCells = mDimX * mDimZ;
+    mBlocked.resize(numCells);
+
+    for (int32_t i = 0; i < numCells; ++i)
+    {
+        mBlocked[i] = !IsFree(sdf, GetCellCenter(i));
+    }
+
+    // Which moves out of each cell are open. Diagonals can't cut blocked corners.
+    std::vector<uint8_t> edges(numCells, 0);
+
+    for (int32_t i = 0; i < numCells; ++i)
+    {
+        for (uint32_t d = 0; d < 8; ++d)
+        {
+            if (IsEdgeFree(sdf, i, d))
+            {
+                edges[i] |= (1 << d);
+            }
+        }
+    }
+
+    mHops.resize(size_t(numCells) * numCells, NAV_NO_HOP);
+    std::vector<int32_t> queue;
+    queue.reserve(numCells);
+
+    for (int32_t target = 0; target < numCells; ++target)
+    {
+        if (!mBlocked[target])
+        {
+            BuildHops(target, edges, queue);
+        }
+    }
+
+    LogDebug("Built nav grid %dx%d (cell size %.1f)", mDimX, mDimZ, mCellSize);
+}
+
+void NavGrid::Clear()
+{
+    mDimX = 0;
+    mDimZ = 0;
+    mBlocked.clear();
+    mHops.clear();
+}
+
+bool NavGrid::IsBuilt() const
+{
+    return !mHops.empty();
+}
+
+bool NavGrid::GetSteerDirection(glm::vec3 from, glm::vec3 to, glm::vec3& outDirection) const
+{
+    int32_t fromCell = GetCell(from);
+    int32_t toCell = GetCell(to);
+
+    if (!IsBuilt() ||
+        fromCell < 0 ||
+        toCell < 0 ||
+        fromCell == toCell ||
+        IsPathClear(from, to))
+    {
+        return false;
+    }
+
+    const size_t rowOffset = size_t(toCell) * mBlocked.size();
+    uint8_t hop = mHops[rowOffset + fromCell];
+
+    if (hop == NAV_NO_HOP)
+    {
+        return false;
+    }
+
+    // Aim two cells ahead to cut across the grid instead of zig-zagging between cell centers.
+    int32_t nextCell = GetNeighbor(fromCell, hop);
+
+    if (nextCell == toCell)
+    {
+        return false;
+    }
+
+    uint8_t nextHop = mHops[rowOffset + nextCell];
+    int32_t aimCell = (nextHop != NAV_NO_HOP) ? GetNeighbor(nextCell, nextHop) : nextCell;
+
+    if (aimCell == toCell)
+    {
+        aimCell = nextCell;
+    }
+
+    glm::vec3 direction = GetCellCenter(aimCell) - from;
+    direction.y = 0.0f;
+
+    float length = glm::length(direction);
+    if (length <= 0.0001f)
+    {
+        return false;
+    }
+
+    outDirection = direction / length;
+    return true;
+}
+
+bool NavGrid::IsPathClear(glm::vec3 from, glm::vec3 to) const
+{
+    glm::vec3 delta = to - from;
+    delta.y = 0.0f;
+
+    // Half a cell apart so the line can't skip over a blocked cell.
+    float length = glm::length(delta);
+    int32_t numSamples = int32_t(length / (mCellSize * 0.5f)) + 1;
+
+    for (int32_t i = 0; i <= numSamples; ++i)
+    {
+        glm::vec3 position = from + delta * (float(i) / numSamples);
+
+        if (IsBlocked(position))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool NavGrid::IsBlocked(glm::vec3 position) const
+{
+    int32_t cell = GetCell(position);
+    return cell < 0 || mBlocked[cell];
+}
+
+int32_t NavGrid::GetCell(glm::vec3 position) const
+{
+    int32_t x = int32_t(floorf((position.x - mOrigin.x) / mCellSize));
+    int32_t z = int32_t(floorf((position.z - mOrigin.z) / mCellSize));
+
+    if (x < 0 || x >= mDimX ||
+        z < 0 || z >= mDimZ)
+    {
+        return -1;
+    }
+
+    return z * mDimX + x;
+}
+
+glm::vec3 NavGrid::GetCellCenter(int32_t cell) const
+{
+    int32_t x = cell % mDimX;
+    int32_t z = cell / mDimX;
+
+    return glm::vec3(
+        mOrigin.x + (x + 0.5f) * mCellSize,
+        NAV_SAMPLE_HEIGHT,
+        mOrigin.z + (z + 0.5f) * mCellSize);
+}
+
+int32_t NavGrid::GetNeighbor(int32_t cell, uint32_t dir) const
+{
+    int32_t x = (cell % mDimX) + NavDirX[dir];
+    int32_t z = (cell / mDimX) + NavDirZ[dir];
+
+    if (x < 0 || x >= mDimX ||
+        z < 0 || z >= mDimZ)
+    {
+        return -1;
+    }
+
+    return z * mDimX + x;
+}
+
+bool NavGrid::IsEdgeFree(const ArenaSdf* sdf, int32_t cell, uint32_t dir) const
+{
+    int32_t neighbor = GetNeighbor(cell, dir);
+
+    if (neighbor < 0 ||
+        mBlocked[cell] ||
+        mBlocked[neighbor])
+    {
+        return false;
+    }
+
+    if (dir & 1)
+    {
+        // Diagonal, both cells it passes between must be open too.
+        if (GetNeighbor(cell, (dir + 7) % 8) < 0 || mBlocked[GetNeighbor(cell, (dir + 7) % 8)] ||
+            GetNeighbor(cell, (dir + 1) % 8) < 0 || mBlocked[GetNeighbor(cell, (dir + 1) % 8)])
+        {
+            return false;
+        }
+    }
+
+    // Catch thin obstacles like goal posts that sit between cell centers.
+    glm::vec3 midpoint = (GetCellCenter(cell) + GetCellCenter(neighbor)) * 0.5f;
+    return IsFree(sdf, midpoint);
+}
+
+bool NavGrid::IsFree(const ArenaSdf* sdf, glm::vec3 position) const
+{
+    if (sdf != nullptr &&
+        sdf->Contains(position))
+    {
+        return sdf->GetDistance(position) >= NAV_CLEARANCE;
+    }
+
+    return fabs(position.x) <= ARENA_EXTENT_X &&
+        fabs(position.z) <= ARENA_EXTENT_Z;
+}
+
+void NavGrid::BuildHops(int32_t target, const std::vector<uint8_t>& edges, std::vector<int32_t>& queue)
+{
+    // Breadth first out from the target. Each cell reached steps back toward the cell it was reached from.
+    uint8_t* hops = &mHops[size_t(target) * mBlocked.size()];
+
+    queue.clear();
+    queue.push_back(target);
+
+    for (size_t head = 0; head < queue.size(); ++head)
+    {
+        int32_t cell = queue[head];
+
+        for (uint32_t d = 0; d < 8; ++d)
+        {
+            if (!(edges[cell] & (1 << d)))
+            {
+                continue;
+            }
+
+            int32_t neighbor = GetNeighbor(cell, d);
+
+            if (neighbor != target &&
+                hops[neighbor] == NAV_NO_HOP)
+            {
+                // Edges are symmetric, so the way back is the opposite direction.
+                hops[neighbor] = uint8_t((d + 4) % 8);
+                queue.push_back(neighbor);
+            }
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <glm/glm.hpp>
+
+class ArenaSdf;
+
+#define NAV_CELL_SIZE 6.0f
+#define NAV_MAX_CELLS 1024
+#define NAV_SAMPLE_HEIGHT 1.5f
+#define NAV_CLEARANCE 1.25f
+#define NAV_NO_HOP 0xff
+
+// Coarse drivable grid over the arena floor, with the next step from every cell toward every other cell.
+// Built from the arena SDF at match start (walls, goal posts and goal mouths come from it),
+// so a bot can look up a steering direction toward any target in constant time.
+class NavGrid
+{
+public:
+
+    void Build(const ArenaSdf* sdf);
+    void Clear();
+    bool IsBuilt() const;
+
+    // Direction (XZ) to steer from "from" to get around obstacles on the way to "to".
+    // Returns false when there is nothing in the way to steer around, or no known path.
+    bool GetSteerDirection(glm::vec3 from, glm::vec3 to, glm::vec3& outDirection) const;
+
+    // True if the straight line from "from" to "to" only crosses open cells.
+    bool IsPathClear(glm::vec3 from, glm::vec3 to) const;
+
+    bool IsBlocked(glm::vec3 position) const;
+
+protected:
+
+    int32_t GetCell(glm::vec3 position) const;
+    glm::vec3 GetCellCenter(int32_t cell) const;
+    int32_t GetNeighbor(int32_t cell, uint32_t dir) const;
+    bool IsEdgeFree(const ArenaSdf* sdf, int32_t cell, uint32_t dir) const;
+    bool IsFree(const ArenaSdf* sdf, glm::vec3 position) const;
+    void BuildHops(int32_t target, const std::vector<uint8_t>& edges, std::vector<int32_t>& queue);
+
+    glm::vec3 mOrigin = {};
+    float mCellSize = NAV_CELL_SIZE;
+    int32_t mDimX = 0;
+    int32_t mDimZ = 0;
+
+    std::vector<uint8_t> mBlocked;
+
+    // mHops[target * numCells + cell] is the direction to step from cell toward target.
+    std::vector<uint8_t> mHops;
+};
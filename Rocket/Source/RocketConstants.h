@@ -15,3 +15,11 @@
 #define ARENA_BOT_EXTENT_Y (ARENA_EXTENT_Y * 0.90f)
 #define ARENA_BOT_EXTENT_Z (ARENA_EXTENT_Z * 0.90f)
 
+#define SIM_TICK_RATE 120
+#define SIM_TIME_STEP (1.0f / SIM_TICK_RATE)
+#define SIM_MAX_STEPS_PER_FRAME 8
+
+#define BALL_RADIUS 1.5f
+#define BALL_RESTITUTION 0.4f
+#define BALL_SOFT_SPEED_LIMIT 30.0f
+#define BALL_HARD_SPEED_LIMIT 80.0f
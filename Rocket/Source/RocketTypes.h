@@ -19,6 +19,15 @@ enum class BotBehavior
     Count
 };
 
+enum class BotDifficulty
+{
+    Rookie,
+    Pro,
+    AllStar,
+
+    Count
+};
+
 enum class BotTargetType
 {
     Ball,
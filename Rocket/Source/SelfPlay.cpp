@@ -0,0 +1,186 @@
+#include "SelfPlay.h"
+#include "GameState.h"
+#include "MatchState.h"
+
+#include <stdio.h>
+#include <chrono>
+#include <thread>
+
+#if PLATFORM_LINUX
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+static uint64_t GetWallTimeUs()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SelfPlayRunner::Initialize(const SelfPlayOptions& options)
+{
+    mOptions = options;
+    mActive = true;
+    mDone = false;
+    mProcessIndex = 0;
+    mNumProcesses = 1;
+
+#if PLATFORM_LINUX
+    mNumProcesses = (options.mNumProcesses != 0) ? options.mNumProcesses : std::thread::hardware_concurrency();
+    mNumProcesses = (mNumProcesses < SELF_PLAY_MAX_PROCESSES) ? mNumProcesses : SELF_PLAY_MAX_PROCESSES;
+    mNumProcesses = (mNumProcesses < options.mNumMatches) ? mNumProcesses : options.mNumMatches;
+    mNumProcesses = (mNumProcesses > 0) ? mNumProcesses : 1;
+
+    printf("Self-play: %u matches, %u processes, %uv%u\n", options.mNumMatches, mNumProcesses, options.mTeamSize, options.mTeamSize);
+    fflush(stdout);
+
+    // Fork before the engine starts so each process gets its own world.
+    for (uint32_t i = 1; i < mNumProcesses; ++i)
+    {
+        pid_t pid = fork();
+
+        if (pid == 0)
+        {
+            mProcessIndex = i;
+            break;
+        }
+
+        mChildPids[i] = (int32_t)pid;
+    }
+#endif
+
+    mMatchIndex = mProcessIndex;
+
+    MatchOptions* matchOptions = GetMatchOptions();
+    matchOptions->mDuration = options.mDuration;
+    matchOptions->mTeamSize = options.mTeamSize;
+    matchOptions->mNumPlayers = 0;
+    matchOptions->mNetworkMode = NetworkMode::Local;
+    matchOptions->mBotDifficulty = options.mBotDifficulty;
+    matchOptions->mBots = true;
+
+    GetGameState()->mHeadless = true;
+    GetGameState()->mTransitionToGame = true;
+
+    BeginMatch();
+}
+
+void SelfPlayRunner::Shutdown()
+{
+    if (!mActive)
+    {
+        return;
+    }
+
+#if PLATFORM_LINUX
+    if (mProcessIndex == 0)
+    {
+        for (uint32_t i = 1; i < mNumProcesses; ++i)
+        {
+            waitpid((pid_t)mChildPids[i], nullptr, 0);
+        }
+
+        printf("Self-play finished.\n");
+        fflush(stdout);
+    }
+#endif
+
+    mActive = false;
+}
+
+bool SelfPlayRunner::IsActive() const
+{
+    return mActive;
+}
+
+bool SelfPlayRunner::IsDone() const
+{
+    return mDone;
+}
+
+const SelfPlayOptions& SelfPlayRunner::GetOptions() const
+{
+    return mOptions;
+}
+
+void SelfPlayRunner::BeginMatch()
+{
+    mStats = SelfPlayStats();
+    mLastFrameTime = GetWallTimeUs();
+}
+
+void SelfPlayRunner::Update()
+{
+    MatchState* match = GetMatchState();
+
+    if (!mActive ||
+        mDone ||
+        match == nullptr)
+    {
+        return;
+    }
+
+    uint64_t now = GetWallTimeUs();
+    double frameTime = double(now - mLastFrameTime) / 1000.0;
+    mLastFrameTime = now;
+
+    if (match->mPhase == MatchPhase::Finished)
+    {
+        return;
+    }
+
+    mStats.mNumTicks += match->GetSimStepCount();
+    mStats.mNumFrames++;
+    mStats.mFrameTime += frameTime;
+    mStats.mMaxFrameTime = (frameTime > mStats.mMaxFrameTime) ? frameTime : mStats.mMaxFrameTime;
+}
+
+bool SelfPlayRunner::FinishMatch(const MatchState* match)
+{
+    float simTime = mStats.mNumTicks * SIM_TIME_STEP;
+    double wallTime = mStats.mFrameTime / 1000.0;
+    double avgFrame = (mStats.mNumFrames > 0) ? (mStats.mFrameTime / mStats.mNumFrames) : 0.0;
+    double avgTick = (mStats.mNumTicks > 0) ? (mStats.mFrameTime * 1000.0 / mStats.mNumTicks) : 0.0;
+
+    printf("Match %u: score %u-%u, touches %u-%u, demos %u-%u%s | %u ticks, %.0fs sim in %.1fs (%.1fx), frame %.3f ms avg %.3f ms max, %.1f us/tick\n",
+        mMatchIndex,
+        match->mTeams[0].mScore, match->mTeams[1].mScore,
+        mStats.mTouches[0], mStats.mTouches[1],
+        mStats.mDemos[0], mStats.mDemos[1],
+        match->mOvertime ? " (OT)" : "",
+        mStats.mNumTicks, simTime, wallTime,
+        (wallTime > 0.0) ? (simTime / wallTime) : 0.0,
+        avgFrame, mStats.mMaxFrameTime, avgTick);
+    fflush(stdout);
+
+    mMatchIndex += mNumProcesses;
+
+    if (mMatchIndex < mOptions.mNumMatches)
+    {
+        BeginMatch();
+        return true;
+    }
+
+    mDone = true;
+    return false;
+}
+
+void SelfPlayRunner::RecordTouch(int32_t team)
+{
+    if (mActive &&
+        team >= 0 &&
+        team < NUM_TEAMS)
+    {
+        mStats.mTouches[team]++;
+    }
+}
+
+void SelfPlayRunner::RecordDemo(int32_t team)
+{
+    if (mActive &&
+        team >= 0 &&
+        team < NUM_TEAMS)
+    {
+        mStats.mDemos[team]++;
+    }
+}
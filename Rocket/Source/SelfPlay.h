@@ -0,0 +1,77 @@
+#pragma once
+
+#include "RocketConstants.h"
+#include "RocketTypes.h"
+
+#include <stdint.h>
+
+#ifndef SELF_PLAY
+#define SELF_PLAY 0
+#endif
+
+#define SELF_PLAY_NUM_MATCHES 16
+#define SELF_PLAY_MATCH_DURATION (60.0f * 5.0f)
+#define SELF_PLAY_TEAM_SIZE MAX_TEAM_SIZE
+#define SELF_PLAY_MAX_PROCESSES 32
+
+class MatchState;
+
+struct SelfPlayOptions
+{
+    uint32_t mNumMatches = SELF_PLAY_NUM_MATCHES;
+
+    // 0 runs one process per core.
+    uint32_t mNumProcesses = 0;
+    uint32_t mTeamSize = SELF_PLAY_TEAM_SIZE;
+    float mDuration = SELF_PLAY_MATCH_DURATION;
+    BotDifficulty mBotDifficulty = BotDifficulty::Pro;
+    bool mAnalyticBallPhysics = true;
+    bool mBotPlanning = true;
+};
+
+struct SelfPlayStats
+{
+    uint32_t mScores[NUM_TEAMS] = {};
+    uint32_t mTouches[NUM_TEAMS] = {};
+    uint32_t mDemos[NUM_TEAMS] = {};
+    uint32_t mNumTicks = 0;
+    uint32_t mNumFrames = 0;
+    double mFrameTime = 0.0;
+    double mMaxFrameTime = 0.0;
+};
+
+// Runs back-to-back all-bot matches with no HUD, menus, audio or input, as fast as the CPU allows.
+// Every frame advances the match by SIM_MAX_STEPS_PER_FRAME fixed steps regardless of wall time.
+// The engine owns a single world per process, so parallel matches run in forked processes (Linux only),
+// each taking every Nth match. Results are printed as each match finishes.
+class SelfPlayRunner
+{
+public:
+
+    void Initialize(const SelfPlayOptions& options);
+    void Shutdown();
+    bool IsActive() const;
+    bool IsDone() const;
+    const SelfPlayOptions& GetOptions() const;
+
+    void BeginMatch();
+    void Update();
+
+    // Prints the finished match. Returns true if this process has another match to run.
+    bool FinishMatch(const MatchState* match);
+
+    void RecordTouch(int32_t team);
+    void RecordDemo(int32_t team);
+
+protected:
+
+    SelfPlayOptions mOptions;
+    SelfPlayStats mStats;
+    uint32_t mProcessIndex = 0;
+    uint32_t mNumProcesses = 1;
+    uint32_t mMatchIndex = 0;
+    int32_t mChildPids[SELF_PLAY_MAX_PROCESSES] = {};
+    uint64_t mLastFrameTime = 0;
+    bool mActive = false;
+    bool mDone = false;
+};
@@ -0,0 +1,108 @@
+#include "SpatialHash.h"
+
+#include "Assertion.h"
+
+#include <string.h>
+
+void SpatialHash::Clear()
+{
+    mNumBodies = 0;
+    memset(mBuckets, 0xff, sizeof(uint32_t) * SPATIAL_HASH_NUM_BUCKETS);
+}
+
+uint32_t SpatialHash::Insert(glm::vec3 position, float radius, void* userData)
+{
+    OCT_ASSERT(mNumBodies < SPATIAL_HASH_MAX_BODIES);
+
+    uint32_t index = mNumBodies++;
+    Body& body = mBodies[index];
+    body.mPosition = position;
+    body.mRadius = radius;
+    body.mUserData = userData;
+    body.mCellX = int32_t(floorf(position.x / SPATIAL_HASH_CELL_SIZE));
+    body.mCellY = int32_t(floorf(position.y / SPATIAL_HASH_CELL_SIZE));
+    body.mCellZ = int32_t(floorf(position.z / SPATIAL_HASH_CELL_SIZE));
+
+    uint32_t bucket = GetBucket(body.mCellX, body.mCellY, body.mCellZ);
+    body.mNext = mBuckets[bucket];
+    mBuckets[bucket] = index;
+
+    return index;
+}
+
+uint32_t SpatialHash::FindPairs(float margin, SpatialHashPair* outPairs, uint32_t maxPairs) const
+{
+    uint32_t numPairs = 0;
+
+    for (uint32_t a = 0; a < mNumBodies; ++a)
+    {
+        const Body& bodyA = mBodies[a];
+
+        for (int32_t dz = -1; dz <= 1; ++dz)
+        {
+            for (int32_t dy = -1; dy <= 1; ++dy)
+            {
+                for (int32_t dx = -1; dx <= 1; ++dx)
+                {
+                    int32_t cellX = bodyA.mCellX + dx;
+                    int32_t cellY = bodyA.mCellY + dy;
+                    int32_t cellZ = bodyA.mCellZ + dz;
+
+                    uint32_t b = mBuckets[GetBucket(cellX, cellY, cellZ)];
+                    while (b != SPATIAL_HASH_INVALID)
+                    {
+                        const Body& bodyB = mBodies[b];
+
+                        // Each pair is reported once, by its lower index. Skip bodies that only share the bucket.
+                        if (b > a &&
+                            bodyB.mCellX == cellX &&
+                            bodyB.mCellY == cellY &&
+                            bodyB.mCellZ == cellZ)
+                        {
+                            glm::vec3 delta = bodyB.mPosition - bodyA.mPosition;
+                            float reach = bodyA.mRadius + bodyB.mRadius + margin;
+
+                            if (glm::dot(delta, delta) < reach * reach &&
+                                numPairs < maxPairs)
+                            {
+                                outPairs[numPairs].mA = a;
+                                outPairs[numPairs].mB = b;
+                                ++numPairs;
+                            }
+                        }
+
+                        b = bodyB.mNext;
+                    }
+                }
+            }
+        }
+    }
+
+    return numPairs;
+}
+
+uint32_t SpatialHash::GetNumBodies() const
+{
+    return mNumBodies;
+}
+
+glm::vec3 SpatialHash::GetPosition(uint32_t index) const
+{
+    return mBodies[index].mPosition;
+}
+
+float SpatialHash::GetRadius(uint32_t index) const
+{
+    return mBodies[index].mRadius;
+}
+
+void* SpatialHash::GetUserData(uint32_t index) const
+{
+    return mBodies[index].mUserData;
+}
+
+uint32_t SpatialHash::GetBucket(int32_t x, int32_t y, int32_t z) const
+{
+    uint32_t hash = (uint32_t(x) * 73856093u) ^ (uint32_t(y) * 19349663u) ^ (uint32_t(z) * 83492791u);
+    return hash % SPATIAL_HASH_NUM_BUCKETS;
+}
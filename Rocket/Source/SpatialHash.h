@@ -0,0 +1,53 @@
+#pragma once
+
+#include "RocketConstants.h"
+
+#include <stdint.h>
+#include <glm/glm.hpp>
+
+#define SPATIAL_HASH_MAX_BODIES MAX_CARS
+#define SPATIAL_HASH_NUM_BUCKETS 64
+#define SPATIAL_HASH_CELL_SIZE 4.0f
+#define SPATIAL_HASH_INVALID 0xffffffff
+
+struct SpatialHashPair
+{
+    uint32_t mA = 0;
+    uint32_t mB = 0;
+};
+
+// Uniform grid over the arena, hashed into a fixed number of buckets.
+// Rebuilt every step from the car positions to find the car pairs that are close enough to touch.
+// Bodies must be smaller than a cell (including the pair margin) since only neighboring cells are searched.
+class SpatialHash
+{
+public:
+
+    void Clear();
+    uint32_t Insert(glm::vec3 position, float radius, void* userData);
+    uint32_t FindPairs(float margin, SpatialHashPair* outPairs, uint32_t maxPairs) const;
+
+    uint32_t GetNumBodies() const;
+    glm::vec3 GetPosition(uint32_t index) const;
+    float GetRadius(uint32_t index) const;
+    void* GetUserData(uint32_t index) const;
+
+protected:
+
+    struct Body
+    {
+        glm::vec3 mPosition = {};
+        float mRadius = 0.0f;
+        void* mUserData = nullptr;
+        int32_t mCellX = 0;
+        int32_t mCellY = 0;
+        int32_t mCellZ = 0;
+        uint32_t mNext = SPATIAL_HASH_INVALID;
+    };
+
+    uint32_t GetBucket(int32_t x, int32_t y, int32_t z) const;
+
+    Body mBodies[SPATIAL_HASH_MAX_BODIES];
+    uint32_t mNumBodies = 0;
+    uint32_t mBuckets[SPATIAL_HASH_NUM_BUCKETS] = {};
+};
@@ -0,0 +1,174 @@
+#include "TaskPool.h"
+
+#include "Assertion.h"
+
+TaskPool::~TaskPool()
+{
+    Shutdown();
+}
+
+void TaskPool::Initialize(uint32_t numThreads)
+{
+    Shutdown();
+
+#if TASK_POOL_THREADED
+    if (numThreads == 0)
+    {
+        uint32_t numCores = std::thread::hardware_concurrency();
+        numThreads = (numCores > 1) ? (numCores - 1) : 0;
+    }
+
+    mNumThreads = (numThreads < TASK_POOL_MAX_THREADS) ? numThreads : TASK_POOL_MAX_THREADS;
+    mQuit = false;
+
+    for (uint32_t i = 0; i < mNumThreads; ++i)
+    {
+        mThreads[i] = std::thread(WorkerMain, this);
+    }
+#endif
+}
+
+void TaskPool::Shutdown()
+{
+    Wait();
+
+#if TASK_POOL_THREADED
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQuit = true;
+    }
+
+    mWakeCondition.notify_all();
+
+    for (uint32_t i = 0; i < mNumThreads; ++i)
+    {
+        mThreads[i].join();
+    }
+#endif
+
+    mNumThreads = 0;
+}
+
+void TaskPool::Dispatch(TaskFunc func, void* data, uint32_t count)
+{
+    // Finish whatever was running before starting something new.
+    Wait();
+
+    if (count == 0)
+    {
+        return;
+    }
+
+#if TASK_POOL_THREADED
+    if (mNumThreads > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mFunc = func;
+            mData = data;
+            mCount = count;
+            mNextIndex = 0;
+            mNumDone = 0;
+            ++mBatch;
+        }
+
+        mWakeCondition.notify_all();
+        return;
+    }
+#endif
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        func(data, i);
+    }
+}
+
+void TaskPool::Wait()
+{
+    if (mCount == 0)
+    {
+        return;
+    }
+
+#if TASK_POOL_THREADED
+    RunTasks();
+
+    // Workers still inside the batch must leave it before it can be replaced.
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDoneCondition.wait(lock, [this]() { return mNumDone >= mCount && mNumActiveWorkers == 0; });
+    mCount = 0;
+#endif
+}
+
+bool TaskPool::IsBusy() const
+{
+#if TASK_POOL_THREADED
+    return mCount > 0 && mNumDone < mCount;
+#else
+    return false;
+#endif
+}
+
+uint32_t TaskPool::GetNumThreads() const
+{
+    return mNumThreads;
+}
+
+void TaskPool::RunTasks()
+{
+#if TASK_POOL_THREADED
+    uint32_t count = mCount;
+
+    while (true)
+    {
+        uint32_t index = mNextIndex++;
+
+        if (index >= count)
+        {
+            break;
+        }
+
+        mFunc(mData, index);
+        ++mNumDone;
+    }
+#endif
+}
+
+#if TASK_POOL_THREADED
+void TaskPool::WorkerMain(TaskPool* pool)
+{
+    uint32_t lastBatch = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(pool->mMutex);
+            pool->mWakeCondition.wait(lock, [pool, lastBatch]() { return pool->mQuit || pool->mBatch != lastBatch; });
+
+            if (pool->mQuit)
+            {
+                break;
+            }
+
+            lastBatch = pool->mBatch;
+
+            if (pool->mCount == 0)
+            {
+                // Woke up after the batch was already finished.
+                continue;
+            }
+
+            ++pool->mNumActiveWorkers;
+        }
+
+        pool->RunTasks();
+
+        {
+            std::lock_guard<std::mutex> lock(pool->mMutex);
+            --pool->mNumActiveWorkers;
+        }
+
+        pool->mDoneCondition.notify_all();
+    }
+}
+#endif
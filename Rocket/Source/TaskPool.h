@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX
+#define TASK_POOL_THREADED 1
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#else
+#define TASK_POOL_THREADED 0
+#endif
+
+#define TASK_POOL_MAX_THREADS 8
+
+typedef void(*TaskFunc)(void* data, uint32_t index);
+
+// Small parallel-for over persistent worker threads. Only one batch is in flight at a time.
+// On platforms without threads (or with no workers) a batch just runs inline when dispatched.
+class TaskPool
+{
+public:
+
+    ~TaskPool();
+
+    // numThreads == 0 picks one less than the number of cores.
+    void Initialize(uint32_t numThreads);
+    void Shutdown();
+
+    // Run func(data, i) for every i in [0, count). Returns immediately when there are workers to run it on.
+    void Dispatch(TaskFunc func, void* data, uint32_t count);
+
+    // Help with the current batch, then block until all of it is done.
+    void Wait();
+
+    bool IsBusy() const;
+    uint32_t GetNumThreads() const;
+
+protected:
+
+    void RunTasks();
+
+    TaskFunc mFunc = nullptr;
+    void* mData = nullptr;
+    uint32_t mCount = 0;
+    uint32_t mNumThreads = 0;
+
+#if TASK_POOL_THREADED
+    static void WorkerMain(TaskPool* pool);
+
+    std::thread mThreads[TASK_POOL_MAX_THREADS];
+    std::mutex mMutex;
+    std::condition_variable mWakeCondition;
+    std::condition_variable mDoneCondition;
+    std::atomic<uint32_t> mNextIndex{ 0 };
+    std::atomic<uint32_t> mNumDone{ 0 };
+    uint32_t mNumActiveWorkers = 0;
+    uint32_t mBatch = 0;
+    bool mQuit = false;
+#endif
+};